@@ -0,0 +1,57 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 09:12:40
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 09:12:40
+ */
+
+#ifndef __CANCEL_TOKEN_H__
+#define __CANCEL_TOKEN_H__
+
+#include <atomic>
+#include <cstdint>
+
+namespace auto_parking_planning
+{
+    /// @brief 协作式取消标记. 记录签发时的代数, 来源代数变化即视为已取消;
+    /// 默认构造的标记永不取消
+    class CancelToken
+    {
+    public:
+        CancelToken() = default;
+
+        CancelToken(const std::atomic<uint64_t> *generation, const uint64_t issued)
+            : m_generation(generation), m_issued(issued)
+        {
+        }
+
+        bool IsCancelled() const
+        {
+            return m_generation != nullptr && m_generation->load(std::memory_order_relaxed) != m_issued;
+        }
+
+    private:
+        const std::atomic<uint64_t> *m_generation = nullptr;
+        uint64_t m_issued = 0;
+    };
+
+    /// @brief 取消来源, 每次 Cancel 使此前签发的所有标记失效
+    class CancelSource
+    {
+    public:
+        /// @brief 返回新的代数, 可用 TokenFor 为之后的请求签发标记
+        uint64_t Cancel() { return m_generation.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+        uint64_t Generation() const { return m_generation.load(std::memory_order_relaxed); }
+
+        CancelToken Token() const { return CancelToken(&m_generation, Generation()); }
+
+        CancelToken TokenFor(const uint64_t generation) const { return CancelToken(&m_generation, generation); }
+
+    private:
+        std::atomic<uint64_t> m_generation{0};
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __CANCEL_TOKEN_H__ */
@@ -0,0 +1,120 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-14 15:12:07
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-14 15:12:07
+ */
+
+#ifndef __INDEX_POOL_H__
+#define __INDEX_POOL_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    /// @brief 单次规划的内存预算, 多个池共享, 超出后分配失败
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget(const size_t limit_bytes = 0) : m_limit(limit_bytes) {}
+
+        void SetLimit(const size_t limit_bytes) { m_limit = limit_bytes; }
+
+        bool Acquire(const size_t bytes)
+        {
+            if (m_used + bytes > m_limit)
+            {
+                return false;
+            }
+            m_used += bytes;
+            return true;
+        }
+
+        void Reset() { m_used = 0; }
+
+        size_t Used() const { return m_used; }
+
+        size_t Limit() const { return m_limit; }
+
+    private:
+        size_t m_limit = 0;
+        size_t m_used = 0;
+    };
+
+    /// @brief 分块对象池, 以 32 位索引引用元素.
+    /// 块在多次规划间保留, Reset 只回绕游标, 不析构也不释放, 因此 T 须为平凡析构类型.
+    /// 索引高位为块号, 低 kChunkBits 位为块内偏移; 一次分配的连续元素不跨块
+    template <typename T, uint32_t kChunkBits = 12>
+    class IndexPool
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "IndexPool requires trivially destructible types");
+
+    public:
+        static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+        static constexpr size_t kChunkBytes = sizeof(T) * kChunkSize;
+
+        explicit IndexPool(MemoryBudget *budget) : m_budget(budget) {}
+
+        /// @brief 分配 count 个连续元素, 返回首元素索引, 超出预算时返回 kInvalidIndex
+        uint32_t Allocate(const uint32_t count = 1)
+        {
+            if (count == 0 || count > kChunkSize)
+            {
+                return kInvalidIndex;
+            }
+            if (m_usedChunks == 0 || m_offset + count > kChunkSize)
+            {
+                if ((m_usedChunks + 1) > (kInvalidIndex >> kChunkBits) || !m_budget->Acquire(kChunkBytes))
+                {
+                    return kInvalidIndex;
+                }
+                if (m_usedChunks == m_chunks.size())
+                {
+                    m_chunks.emplace_back(new T[kChunkSize]);
+                }
+                ++m_usedChunks;
+                m_offset = 0;
+            }
+            const uint32_t index = ((m_usedChunks - 1) << kChunkBits) | m_offset;
+            m_offset += count;
+            m_size += count;
+            return index;
+        }
+
+        T &operator[](const uint32_t index) { return m_chunks[index >> kChunkBits][index & (kChunkSize - 1)]; }
+
+        const T &operator[](const uint32_t index) const
+        {
+            return m_chunks[index >> kChunkBits][index & (kChunkSize - 1)];
+        }
+
+        /// @brief O(1) 复位, 已申请的块留给下一次规划
+        void Reset()
+        {
+            m_usedChunks = 0;
+            m_offset = 0;
+            m_size = 0;
+        }
+
+        /// @brief 本次规划已分配的元素数
+        uint32_t Size() const { return m_size; }
+
+        size_t ReservedBytes() const { return m_chunks.size() * kChunkBytes; }
+
+    private:
+        MemoryBudget *m_budget;
+        std::vector<std::unique_ptr<T[]>> m_chunks;
+        uint32_t m_usedChunks = 0;
+        uint32_t m_offset = 0;
+        uint32_t m_size = 0;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __INDEX_POOL_H__ */
@@ -0,0 +1,113 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-20 19:31:52
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-20 19:31:52
+ */
+
+#ifndef __LATEST_MAILBOX_H__
+#define __LATEST_MAILBOX_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace auto_parking_planning
+{
+    /// @brief 单生产者单消费者的"最新值"信箱, 三缓冲实现.
+    /// 写端与读端各持有一个槽位, 第三个槽位通过原子交换在两者之间传递, 取值不加锁.
+    /// 只有 WaitFor 的阻塞等待用到互斥量, 写端通知前短暂持有它, 不会丢失唤醒.
+    /// 读端取走之前的多次写入只保留最后一次, 被覆盖的次数计入 Superseded
+    template <typename T>
+    class LatestMailbox
+    {
+    public:
+        /// @brief 写端调用, 不等待读端取值
+        void Post(const T &value)
+        {
+            m_slots[m_back] = value;
+            const uint8_t prev = m_latest.exchange(static_cast<uint8_t>(m_back | kFresh), std::memory_order_acq_rel);
+            m_back = prev & kIndexMask;
+            m_posted.fetch_add(1, std::memory_order_relaxed);
+            if (prev & kFresh)
+            {
+                m_superseded.fetch_add(1, std::memory_order_relaxed);
+            }
+            // 持锁片刻再通知: 读端要么还未检查条件, 会看到新值; 要么已在等待, 会收到通知
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+            }
+            m_wake.notify_one();
+        }
+
+        /// @brief 读端调用, 有未读的新值时取出并返回 true
+        bool Take(T *value)
+        {
+            if (!HasFresh())
+            {
+                return false;
+            }
+            const uint8_t prev = m_latest.exchange(m_front, std::memory_order_acq_rel);
+            m_front = prev & kIndexMask;
+            *value = m_slots[m_front];
+            return true;
+        }
+
+        /// @brief 读端调用, 最多等待 timeout, 期间收到新值则立即唤醒并取出
+        template <typename Rep, typename Period>
+        bool WaitFor(const std::chrono::duration<Rep, Period> &timeout, T *value)
+        {
+            if (Take(value))
+            {
+                return true;
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                m_wake.wait_for(lock, timeout, [this]() { return HasFresh() || m_interrupted; });
+                m_interrupted = false;
+            }
+            return Take(value);
+        }
+
+        /// @brief 唤醒等待中的读端(例如退出时)
+        void Interrupt()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_interrupted = true;
+            }
+            m_wake.notify_all();
+        }
+
+        bool HasFresh() const { return (m_latest.load(std::memory_order_acquire) & kFresh) != 0; }
+
+        /// @brief 累计写入次数
+        uint64_t Posted() const { return m_posted.load(std::memory_order_relaxed); }
+
+        /// @brief 累计未被读取即被覆盖的次数
+        uint64_t Superseded() const { return m_superseded.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint8_t kIndexMask = 0x3;
+        static constexpr uint8_t kFresh = 0x4;
+
+        T m_slots[3];
+        /// 中间槽位编号, kFresh 表示读端尚未取走
+        std::atomic<uint8_t> m_latest{1};
+        /// 写端独占
+        uint8_t m_back = 0;
+        /// 读端独占
+        uint8_t m_front = 2;
+        std::atomic<uint64_t> m_posted{0};
+        std::atomic<uint64_t> m_superseded{0};
+
+        std::mutex m_waitMutex;
+        std::condition_variable m_wake;
+        bool m_interrupted = false;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __LATEST_MAILBOX_H__ */
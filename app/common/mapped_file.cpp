@@ -0,0 +1,220 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 20:31:47
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 20:31:47
+ */
+#include "mapped_file.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace auto_parking_planning
+{
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    void MappedFile::MoveFrom(MappedFile &other)
+    {
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+#ifdef _WIN32
+        m_file = other.m_file;
+        m_mapping = other.m_mapping;
+        other.m_file = nullptr;
+        other.m_mapping = nullptr;
+#endif
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::Open(const std::string &path)
+    {
+        Close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<const uint8_t *>(data);
+        m_size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != nullptr)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != nullptr)
+        {
+            CloseHandle(m_file);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_file = nullptr;
+        m_mapping = nullptr;
+    }
+
+    size_t MappedFile::PageSize()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }
+
+    void MappedFile::WillNeed(const size_t offset, const size_t size) const
+    {
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+        if (m_data == nullptr || offset >= m_size)
+        {
+            return;
+        }
+        const size_t page = PageSize();
+        const size_t begin = offset / page * page;
+        const size_t end = std::min(m_size, offset + size);
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<uint8_t *>(m_data) + begin;
+        range.NumberOfBytes = end - begin;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        (void)offset;
+        (void)size;
+#endif
+    }
+
+    void MappedFile::DontNeed(const size_t offset, const size_t size) const
+    {
+        const size_t page = PageSize();
+        if (m_data == nullptr || offset % page != 0 || offset >= m_size)
+        {
+            return;
+        }
+        // 对未锁定的区间调用 VirtualUnlock 会把页面移出工作集, 此时返回 ERROR_NOT_LOCKED 属预期.
+        // 只读映射的页面无需写回, 之后访问时从系统缓存或文件重新调入
+        VirtualUnlock(const_cast<uint8_t *>(m_data) + offset, std::min(size, m_size - offset));
+    }
+
+#else
+
+    bool MappedFile::Open(const std::string &path)
+    {
+        Close();
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // 映射建立后文件描述符即可关闭
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        m_data = static_cast<const uint8_t *>(data);
+        m_size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<uint8_t *>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    size_t MappedFile::PageSize() { return static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
+
+    void MappedFile::WillNeed(const size_t offset, const size_t size) const
+    {
+        if (m_data == nullptr || offset >= m_size)
+        {
+            return;
+        }
+        // 起点向下对齐到页
+        const size_t page = PageSize();
+        const size_t begin = offset / page * page;
+        const size_t end = std::min(m_size, offset + size);
+        madvise(const_cast<uint8_t *>(m_data) + begin, end - begin, MADV_WILLNEED);
+    }
+
+    void MappedFile::DontNeed(const size_t offset, const size_t size) const
+    {
+        const size_t page = PageSize();
+        if (m_data == nullptr || offset % page != 0 || offset >= m_size)
+        {
+            return;
+        }
+        madvise(const_cast<uint8_t *>(m_data) + offset, std::min(size, m_size - offset), MADV_DONTNEED);
+    }
+
+#endif
+
+} // namespace auto_parking_planning
@@ -0,0 +1,63 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 20:25:08
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 20:25:08
+ */
+
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace auto_parking_planning
+{
+    /// @brief 只读内存映射文件, 页面按需由操作系统加载
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        bool Open(const std::string &path);
+
+        void Close();
+
+        bool IsOpen() const { return m_data != nullptr; }
+
+        const uint8_t *Data() const { return m_data; }
+
+        size_t Size() const { return m_size; }
+
+        /// @brief 虚拟内存页大小, WillNeed 与 DontNeed 以此为单位
+        static size_t PageSize();
+
+        /// @brief 提示系统 [offset, offset + size) 即将被访问, 异步预读. Windows 8 之前的系统不做处理
+        void WillNeed(const size_t offset, const size_t size) const;
+
+        /// @brief 释放 [offset, offset + size) 已加载的页面, 之后访问时重新从文件读入.
+        /// 区间起点须按页对齐, 否则不做处理. Windows 上把页面移出进程工作集
+        void DontNeed(const size_t offset, const size_t size) const;
+
+    private:
+        void MoveFrom(MappedFile &other);
+
+    private:
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void *m_file = nullptr;
+        void *m_mapping = nullptr;
+#endif
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __MAPPED_FILE_H__ */
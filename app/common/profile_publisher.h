@@ -0,0 +1,32 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-14 10:25:40
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-14 10:25:40
+ */
+
+#ifndef __PROFILE_PUBLISHER_H__
+#define __PROFILE_PUBLISHER_H__
+
+#include "profiler.h"
+#include "xvizMsgBridge.h"
+
+namespace auto_parking_planning
+{
+    /// @brief 以 FloatDataPub 发布一个规划周期的汇总值, 未开启性能统计时不发布
+    inline void PublishProfileFrame(xviz::XvizMsgBridge *bridge, const ProfileFrame &frame)
+    {
+#ifdef AUTO_PARKING_ENABLE_PROFILING
+        for (int i = 0; i < kProfileChannelCount; ++i)
+        {
+            bridge->FloatDataPub(ChannelName(static_cast<ProfileChannel>(i)), frame.values[i]);
+        }
+#else
+        (void)bridge;
+        (void)frame;
+#endif
+    }
+
+} // namespace auto_parking_planning
+
+#endif /* __PROFILE_PUBLISHER_H__ */
@@ -0,0 +1,83 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-14 10:08:55
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-14 10:08:55
+ */
+#include "profiler.h"
+
+namespace auto_parking_planning
+{
+
+    const char *ChannelName(const ProfileChannel channel)
+    {
+        switch (channel)
+        {
+        case ProfileChannel::SEARCH_TIME:
+            return "search_ms";
+        case ProfileChannel::EXPANSIONS:
+            return "expansions";
+        case ProfileChannel::COLLISION_CHECKS:
+            return "collision_checks";
+        case ProfileChannel::SMOOTHING_TIME:
+            return "smoothing_ms";
+        case ProfileChannel::POOL_BUSY_TIME:
+            return "pool_busy_ms";
+        case ProfileChannel::POOL_TASKS:
+            return "pool_tasks";
+        default:
+            break;
+        }
+        return "unknown";
+    }
+
+    bool IsTimerChannel(const ProfileChannel channel)
+    {
+        return channel == ProfileChannel::SEARCH_TIME || channel == ProfileChannel::SMOOTHING_TIME ||
+               channel == ProfileChannel::POOL_BUSY_TIME;
+    }
+
+    Profiler &Profiler::Instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler::ThreadBuffer *Profiler::Register()
+    {
+        // 缓冲区只增不删, 线程退出后其累计值仍可被汇总
+        ThreadBuffer *buffer = new ThreadBuffer();
+        ThreadBuffer *head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            buffer->next = head;
+        } while (!m_head.compare_exchange_weak(head, buffer, std::memory_order_release,
+                                               std::memory_order_relaxed));
+        return buffer;
+    }
+
+    ProfileFrame Profiler::Collect()
+    {
+        std::lock_guard<std::mutex> lock(m_collectMtx);
+        uint64_t totals[kProfileChannelCount] = {};
+        for (ThreadBuffer *buffer = m_head.load(std::memory_order_acquire); buffer != nullptr;
+             buffer = buffer->next)
+        {
+            for (int i = 0; i < kProfileChannelCount; ++i)
+            {
+                const uint64_t value = buffer->values[i].load(std::memory_order_relaxed);
+                totals[i] += value - buffer->collected[i];
+                buffer->collected[i] = value;
+            }
+        }
+
+        ProfileFrame frame;
+        for (int i = 0; i < kProfileChannelCount; ++i)
+        {
+            const bool is_timer = IsTimerChannel(static_cast<ProfileChannel>(i));
+            frame.values[i] = is_timer ? static_cast<float>(totals[i] * 1e-6) : static_cast<float>(totals[i]);
+        }
+        return frame;
+    }
+
+} // namespace auto_parking_planning
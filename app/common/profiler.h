@@ -0,0 +1,128 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-14 09:46:21
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-14 09:46:21
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// 热点路径计时与计数. 定义 AUTO_PARKING_ENABLE_PROFILING 时生效,
+// 否则 APP_PROFILE_* 宏展开为空语句, 不产生任何代码
+namespace auto_parking_planning
+{
+    enum class ProfileChannel : int
+    {
+        SEARCH_TIME = 0,
+        EXPANSIONS,
+        COLLISION_CHECKS,
+        SMOOTHING_TIME,
+        /// 调度器工作线程执行任务的时间与任务数
+        POOL_BUSY_TIME,
+        POOL_TASKS,
+        COUNT
+    };
+
+    constexpr int kProfileChannelCount = static_cast<int>(ProfileChannel::COUNT);
+
+    /// @brief 通道名, 同时作为 FloatDataPub 的名称
+    const char *ChannelName(const ProfileChannel channel);
+
+    /// @brief 计时通道以纳秒累加, 汇总时换算为毫秒
+    bool IsTimerChannel(const ProfileChannel channel);
+
+    /// @brief 一个规划周期的汇总值
+    struct ProfileFrame
+    {
+        float values[kProfileChannelCount] = {};
+
+        float Get(const ProfileChannel channel) const { return values[static_cast<int>(channel)]; }
+    };
+
+    class Profiler
+    {
+    public:
+        /// 每个线程独占一个缓冲区, 仅由所属线程写入, 写入不加锁也不使用原子读改写
+        struct ThreadBuffer
+        {
+            std::atomic<uint64_t> values[kProfileChannelCount] = {};
+            uint64_t collected[kProfileChannelCount] = {};
+            ThreadBuffer *next = nullptr;
+        };
+
+        static Profiler &Instance();
+
+        void Add(const ProfileChannel channel, const uint64_t value)
+        {
+            std::atomic<uint64_t> &slot = LocalBuffer()->values[static_cast<int>(channel)];
+            slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        /// @brief 汇总所有线程自上次 Collect 以来的增量, 每个规划周期调用一次
+        ProfileFrame Collect();
+
+    private:
+        Profiler() = default;
+
+        ThreadBuffer *LocalBuffer()
+        {
+            static thread_local ThreadBuffer *t_buffer = nullptr;
+            if (t_buffer == nullptr)
+            {
+                t_buffer = Register();
+            }
+            return t_buffer;
+        }
+
+        ThreadBuffer *Register();
+
+    private:
+        std::atomic<ThreadBuffer *> m_head{nullptr};
+        std::mutex m_collectMtx;
+    };
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const ProfileChannel channel)
+            : m_channel(channel), m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            Profiler::Instance().Add(
+                m_channel, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        ProfileChannel m_channel;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+} // namespace auto_parking_planning
+
+#define APP_PROFILE_CONCAT_INNER(a, b) a##b
+#define APP_PROFILE_CONCAT(a, b) APP_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef AUTO_PARKING_ENABLE_PROFILING
+#define APP_PROFILE_SCOPE(channel) \
+    ::auto_parking_planning::ScopedTimer APP_PROFILE_CONCAT(app_profile_timer_, __LINE__)(channel)
+#define APP_PROFILE_COUNT(channel, value) \
+    ::auto_parking_planning::Profiler::Instance().Add(channel, static_cast<uint64_t>(value))
+#else
+#define APP_PROFILE_SCOPE(channel) ((void)0)
+#define APP_PROFILE_COUNT(channel, value) ((void)0)
+#endif
+
+#endif /* __PROFILER_H__ */
@@ -0,0 +1,46 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 20:12:31
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 20:12:31
+ */
+
+#ifndef __SPAN_H__
+#define __SPAN_H__
+
+#include <cstddef>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 只读连续内存视图, 不持有数据
+    template <typename T>
+    class Span
+    {
+    public:
+        constexpr Span() noexcept = default;
+
+        constexpr Span(const T *data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+        Span(const std::vector<T> &vec) noexcept : m_data(vec.data()), m_size(vec.size()) {}
+
+        const T *data() const { return m_data; }
+
+        size_t size() const { return m_size; }
+
+        bool empty() const { return m_size == 0; }
+
+        const T *begin() const { return m_data; }
+
+        const T *end() const { return m_data + m_size; }
+
+        const T &operator[](size_t i) const { return m_data[i]; }
+
+    private:
+        const T *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __SPAN_H__ */
@@ -0,0 +1,222 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 15:02:47
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 15:02:47
+ */
+#include "task_scheduler.h"
+#include "profiler.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        /// 当前线程所属的调度器与工作线程编号
+        thread_local const TaskScheduler *t_scheduler = nullptr;
+        thread_local int t_workerIndex = -1;
+
+        void PinCurrentThread(const int cpu)
+        {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+            (void)cpu;
+#endif
+        }
+    }
+
+    TaskScheduler::TaskScheduler(const TaskSchedulerConfig &config) : m_created(std::chrono::steady_clock::now())
+    {
+        const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        const int workers = config.workers >= 0 ? config.workers : std::max(0, hardware - 1);
+        for (int i = 0; i < workers; ++i)
+        {
+            m_workers.emplace_back(new Worker());
+        }
+        for (int i = 0; i < workers; ++i)
+        {
+            m_workers[i]->thread = std::thread([this, i, config, hardware]() {
+                if (config.pinThreads && hardware > 0)
+                {
+                    PinCurrentThread((i + 1) % hardware);
+                }
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_sleep.notify_all();
+        for (auto &worker : m_workers)
+        {
+            worker->thread.join();
+        }
+    }
+
+    TaskScheduler &TaskScheduler::Instance()
+    {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+
+    int TaskScheduler::LocalIndex() const { return t_scheduler == this ? t_workerIndex : -1; }
+
+    void TaskScheduler::Push(Item &&item)
+    {
+        // 工作线程提交到自己的队列, 保持局部性; 外部线程轮流分配
+        int index = LocalIndex();
+        if (index < 0)
+        {
+            index = static_cast<int>(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+        }
+        // 先计数再入队, 保证任务被取走前计数已包含它
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        Worker &worker = *m_workers[index];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.deque.push_back(std::move(item));
+        }
+        m_sleep.notify_one();
+    }
+
+    bool TaskScheduler::TryRunOne()
+    {
+        if (m_queued.load(std::memory_order_relaxed) == 0)
+        {
+            return false;
+        }
+        const int self = LocalIndex();
+        const int count = WorkerCount();
+        Worker *local = self >= 0 ? m_workers[self].get() : nullptr;
+        Item item;
+        if (local != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(local->mutex);
+            if (!local->deque.empty())
+            {
+                item = std::move(local->deque.back());
+                local->deque.pop_back();
+            }
+        }
+        for (int k = 1; !item.fn && k <= count; ++k)
+        {
+            Worker &victim = *m_workers[(std::max(self, 0) + k) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.deque.empty())
+            {
+                item = std::move(victim.deque.front());
+                victim.deque.pop_front();
+                if (local != nullptr)
+                {
+                    local->steals.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        if (!item.fn)
+        {
+            return false;
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        Execute(item, local);
+        return true;
+    }
+
+    void TaskScheduler::Execute(Item &item, Worker *worker)
+    {
+        if (worker == nullptr)
+        {
+            item.fn();
+            m_externalTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            const auto start = std::chrono::steady_clock::now();
+            item.fn();
+            const uint64_t elapsed = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            worker->busyNs.fetch_add(elapsed, std::memory_order_relaxed);
+            worker->tasks.fetch_add(1, std::memory_order_relaxed);
+            APP_PROFILE_COUNT(ProfileChannel::POOL_BUSY_TIME, elapsed);
+        }
+        APP_PROFILE_COUNT(ProfileChannel::POOL_TASKS, 1);
+        item.group->m_pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    void TaskScheduler::WorkerLoop(const int index)
+    {
+        t_scheduler = this;
+        t_workerIndex = index;
+        for (;;)
+        {
+            if (TryRunOne())
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleep.wait(lock, [this]() { return m_stop || m_queued.load(std::memory_order_relaxed) > 0; });
+            if (m_stop)
+            {
+                return;
+            }
+        }
+    }
+
+    TaskSchedulerStats TaskScheduler::Stats() const
+    {
+        TaskSchedulerStats stats;
+        stats.workers = WorkerCount();
+        uint64_t busy_ns = 0;
+        for (const auto &worker : m_workers)
+        {
+            stats.tasks += worker->tasks.load(std::memory_order_relaxed);
+            stats.steals += worker->steals.load(std::memory_order_relaxed);
+            busy_ns += worker->busyNs.load(std::memory_order_relaxed);
+        }
+        stats.tasks += m_externalTasks.load(std::memory_order_relaxed);
+        stats.busyMs = busy_ns * 1e-6;
+        stats.elapsedMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_created).count();
+        return stats;
+    }
+
+    void TaskGroup::Run(TaskScheduler::Task fn)
+    {
+        if (m_scheduler->m_workers.empty())
+        {
+            fn();
+            return;
+        }
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        TaskScheduler::Item item;
+        item.fn = std::move(fn);
+        item.group = this;
+        m_scheduler->Push(std::move(item));
+    }
+
+    void TaskGroup::Wait()
+    {
+        while (m_pending.load(std::memory_order_acquire) > 0)
+        {
+            if (!m_scheduler->TryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+} // namespace auto_parking_planning
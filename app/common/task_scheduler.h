@@ -0,0 +1,171 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 14:36:08
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 14:36:08
+ */
+
+#ifndef __TASK_SCHEDULER_H__
+#define __TASK_SCHEDULER_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct TaskSchedulerConfig
+    {
+        /// 工作线程数, 负数表示硬件线程数减一(调用线程也参与执行)
+        int workers = -1;
+        /// 把第 i 个工作线程绑定到第 i + 1 个核, 仅 Linux 有效
+        bool pinThreads = false;
+    };
+
+    struct TaskSchedulerStats
+    {
+        int workers = 0;
+        uint64_t tasks = 0;
+        uint64_t steals = 0;
+        /// 工作线程执行任务的累计时间
+        double busyMs = 0.0;
+        /// 调度器创建以来的时间
+        double elapsedMs = 0.0;
+
+        /// 工作线程平均占用率
+        double Utilization() const { return workers > 0 && elapsedMs > 0.0 ? busyMs / (elapsedMs * workers) : 0.0; }
+    };
+
+    class TaskGroup;
+
+    /// @brief 工作窃取任务调度器. 每个工作线程有自己的双端队列, 从队尾取自己的任务,
+    /// 空闲时从其他队列的队首窃取; 等待任务组的线程同样参与执行, 因此可嵌套并行.
+    /// 规划各子系统共用 Instance(), 不再各自创建线程
+    class TaskScheduler
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        explicit TaskScheduler(const TaskSchedulerConfig &config = TaskSchedulerConfig());
+
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler &) = delete;
+        TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+        /// @brief 进程共享的调度器, 首次调用时以默认配置创建
+        static TaskScheduler &Instance();
+
+        int WorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+        /// @brief 可同时执行的线程数(工作线程加调用线程)
+        int Concurrency() const { return WorkerCount() + 1; }
+
+        /// @brief 把 [begin, end) 按 grain 切块并行执行 fn(chunk_begin, chunk_end), 返回时全部完成.
+        /// 第一块由调用线程执行
+        template <typename F>
+        void ParallelFor(const size_t begin, const size_t end, size_t grain, const F &fn);
+
+        TaskSchedulerStats Stats() const;
+
+    private:
+        friend class TaskGroup;
+
+        struct Item
+        {
+            Task fn;
+            TaskGroup *group = nullptr;
+        };
+
+        struct alignas(64) Worker
+        {
+            std::mutex mutex;
+            std::deque<Item> deque;
+            std::thread thread;
+            std::atomic<uint64_t> tasks{0};
+            std::atomic<uint64_t> steals{0};
+            std::atomic<uint64_t> busyNs{0};
+        };
+
+        void Push(Item &&item);
+
+        /// @brief 取一个任务执行, 没有可执行的任务时返回 false
+        bool TryRunOne();
+
+        void Execute(Item &item, Worker *worker);
+
+        void WorkerLoop(const int index);
+
+        /// @brief 当前线程在本调度器中的工作线程编号, 非工作线程为 -1
+        int LocalIndex() const;
+
+    private:
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<size_t> m_queued{0};
+        std::atomic<uint32_t> m_nextQueue{0};
+        std::atomic<uint64_t> m_externalTasks{0};
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleep;
+        bool m_stop = false;
+        std::chrono::steady_clock::time_point m_created;
+    };
+
+    /// @brief 一组任务, Wait 返回时组内任务全部完成. 析构时自动等待
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(TaskScheduler *scheduler = &TaskScheduler::Instance()) : m_scheduler(scheduler) {}
+
+        ~TaskGroup() { Wait(); }
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /// @brief 提交任务, 调度器没有工作线程时立即在当前线程执行
+        void Run(TaskScheduler::Task fn);
+
+        /// @brief 等待期间当前线程执行队列中的任务
+        void Wait();
+
+    private:
+        friend class TaskScheduler;
+
+        TaskScheduler *m_scheduler;
+        std::atomic<size_t> m_pending{0};
+    };
+
+    template <typename F>
+    void TaskScheduler::ParallelFor(const size_t begin, const size_t end, size_t grain, const F &fn)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+        if (m_workers.empty() || end - begin <= grain)
+        {
+            fn(begin, end);
+            return;
+        }
+        TaskGroup group(this);
+        for (size_t chunk_begin = begin + grain; chunk_begin < end; chunk_begin += grain)
+        {
+            const size_t chunk_end = std::min(end, chunk_begin + grain);
+            group.Run([&fn, chunk_begin, chunk_end]() { fn(chunk_begin, chunk_end); });
+        }
+        fn(begin, begin + grain);
+        group.Wait();
+    }
+
+} // namespace auto_parking_planning
+
+#endif /* __TASK_SCHEDULER_H__ */
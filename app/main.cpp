@@ -2,15 +2,212 @@
  * @Author: Xia Yunkai
  * @Date:   2024-01-08 21:33:57
  * @Last Modified by:   Xia Yunkai
- * @Last Modified time: 2024-01-08 21:33:58
+ * @Last Modified time: 2024-01-21 11:20:14
  */
+#include "record/scenario_log.h"
+#include "service/planning_service.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef XVIZ_HEADLESS_BRIDGE
+#include "headless_bridge.h"
+#endif
 
 using namespace std;
+using namespace auto_parking_planning;
 
+namespace
+{
+    struct AppOptions
+    {
+        string logPath;
+        size_t index = 0;
+        string rsTablePath;
+        string pubConnect;
+        string subConnect;
+        double budgetMs = 0.0;
+        string tiledMapPath;
+        float windowSize = 0.0f;
+        float pathTolerance = -1.0f;
+        int demoGoals = 0;
+    };
+
+    atomic<bool> g_quit{false};
+
+    void OnSignal(int) { g_quit = true; }
+
+    void PrintUsage()
+    {
+        cerr << "usage: auto_parking_planning [options]\n"
+             << "  --log FILE       plan on a scenario from a recorded scenario log\n"
+             << "  --index I        scenario index in the log (default 0)\n"
+             << "  --rs-table FILE  use a precomputed Reeds-Shepp heuristic table\n"
+             << "  --pub ADDR       bridge publish endpoint\n"
+             << "  --sub ADDR       bridge subscribe endpoint\n"
+             << "  --budget MS      anytime planning with a per-request deadline of MS milliseconds\n"
+             << "  --tiled-map FILE plan in windows loaded on demand from a tiled map file\n"
+             << "  --window M       planning window size in meters for --tiled-map (default 60)\n"
+             << "  --path-tolerance M  simplify published paths to within M meters, 0 publishes every point\n"
+             << "                   (default 0.02)\n"
+#ifdef XVIZ_HEADLESS_BRIDGE
+             << "  --demo N         loop back the scenario start and a burst of N goals, then exit\n"
+#endif
+            ;
+    }
+
+    bool ParseOptions(int argc, char const *argv[], AppOptions *options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--log" && has_value)
+                options->logPath = argv[++i];
+            else if (arg == "--index" && has_value)
+                options->index = strtoul(argv[++i], nullptr, 10);
+            else if (arg == "--rs-table" && has_value)
+                options->rsTablePath = argv[++i];
+            else if (arg == "--pub" && has_value)
+                options->pubConnect = argv[++i];
+            else if (arg == "--sub" && has_value)
+                options->subConnect = argv[++i];
+            else if (arg == "--budget" && has_value)
+                options->budgetMs = atof(argv[++i]);
+            else if (arg == "--tiled-map" && has_value)
+                options->tiledMapPath = argv[++i];
+            else if (arg == "--window" && has_value)
+                options->windowSize = static_cast<float>(atof(argv[++i]));
+            else if (arg == "--path-tolerance" && has_value)
+                options->pathTolerance = max(0.0f, static_cast<float>(atof(argv[++i])));
+#ifdef XVIZ_HEADLESS_BRIDGE
+            else if (arg == "--demo" && has_value)
+                options->demoGoals = max(1, atoi(argv[++i]));
+#endif
+            else
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief 没有场景日志时使用的 40m x 40m 空地图
+    xviz::GridMap EmptyMap(vector<unsigned char> *grid)
+    {
+        xviz::GridMap map;
+        map.m_res = 0.1f;
+        map.m_size = xviz::Vec2f(400.0f, 400.0f);
+        map.m_origin = xviz::Vec2f(-20.0f, -20.0f);
+        map.m_originYaw = 0.0f;
+        grid->assign(400 * 400, 0);
+        map.m_data = grid->data();
+        return map;
+    }
+
+#ifdef XVIZ_HEADLESS_BRIDGE
+    /// @brief 回环发送起点和一串逐渐逼近真实目标的目标点, 模拟连续点击, 最后一个为场景目标
+    void RunDemo(PlanningService *service, const xviz::Pose &start, const xviz::Pose &target, const int goals)
+    {
+        xviz::headless::SendInitPose(start);
+        for (int i = goals - 1; i >= 0; --i)
+        {
+            xviz::Pose goal = target;
+            goal.x += 0.2f * i;
+            xviz::headless::SendTargetPose(goal);
+            this_thread::sleep_for(chrono::milliseconds(2));
+        }
+        const auto deadline = chrono::steady_clock::now() + chrono::seconds(30);
+        while (!g_quit && chrono::steady_clock::now() < deadline)
+        {
+            const PlanningServiceStats stats = service->Stats();
+            if (stats.requests == static_cast<uint64_t>(goals) &&
+                stats.superseded + stats.cancelled + stats.published + stats.failed + stats.mapUnavailable ==
+                    stats.requests)
+            {
+                break;
+            }
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+#endif
+}
 
 int main(int argc, char const *argv[])
 {
-    /* code */
+    AppOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    PlanningServiceConfig config;
+    config.planner.search.rsTablePath = options.rsTablePath;
+    config.budgetMs = options.budgetMs;
+    config.tiledMapPath = options.tiledMapPath;
+    if (options.windowSize > 0.0f)
+        config.windowSize = options.windowSize;
+    if (options.pathTolerance >= 0.0f)
+        config.pathTolerance = options.pathTolerance;
+    if (!options.pubConnect.empty())
+        config.pubConnect = options.pubConnect;
+    if (!options.subConnect.empty())
+        config.subConnect = options.subConnect;
+    PlanningService service(config);
+
+    ScenarioLogReader reader;
+    ScenarioView view;
+    vector<unsigned char> empty_grid;
+    if (!options.logPath.empty())
+    {
+        if (!reader.Open(options.logPath) || !reader.Get(options.index, &view))
+        {
+            cerr << "failed to load scenario " << options.index << " from " << options.logPath << endl;
+            return 1;
+        }
+        ObstacleView obstacles;
+        obstacles.polygonOffsets = view.polygonOffsets;
+        obstacles.vertices = view.vertices;
+        obstacles.points = view.points;
+        service.SetMap(view.map, obstacles);
+    }
+    else
+    {
+        view.map = EmptyMap(&empty_grid);
+        view.target = xviz::Pose(5.0f, 2.0f, 1.57f);
+        service.SetMap(view.map);
+    }
+
+    if (!service.Start())
+    {
+        cerr << "failed to start planning service" << endl;
+        return 1;
+    }
+    service.Bridge().GridMapPub("grid_map", view.map);
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+#ifdef XVIZ_HEADLESS_BRIDGE
+    if (options.demoGoals > 0)
+    {
+        RunDemo(&service, view.start, view.target, options.demoGoals);
+        g_quit = true;
+    }
+#endif
+    while (!g_quit)
+    {
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    service.Stop();
+
+    const PlanningServiceStats stats = service.Stats();
+    fprintf(stderr, "requests %llu superseded %llu cancelled %llu published %llu failed %llu map_unavailable %llu\n",
+            static_cast<unsigned long long>(stats.requests), static_cast<unsigned long long>(stats.superseded),
+            static_cast<unsigned long long>(stats.cancelled), static_cast<unsigned long long>(stats.published),
+            static_cast<unsigned long long>(stats.failed), static_cast<unsigned long long>(stats.mapUnavailable));
     return 0;
 }
@@ -0,0 +1,163 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-25 20:02:47
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-25 20:02:47
+ */
+#include "bit_grid.h"
+#include "grid_map_utils.h"
+#include <algorithm>
+#include <cstring>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        int CeilLog2(const int n)
+        {
+            int bits = 0;
+            while ((1 << bits) < n)
+            {
+                ++bits;
+            }
+            return bits;
+        }
+
+        /// @brief 把 v 的低 own_bits 位展开到 Morton 序号中: 两轴共有的低位交错排列(x 在偶数位),
+        /// 较长一轴多出的高位接在其后, 非正方形地图也不会浪费序号空间
+        uint32_t Spread(const uint32_t v, const int own_bits, const int other_bits, const int offset)
+        {
+            const int shared = std::min(own_bits, other_bits);
+            uint32_t code = 0;
+            for (int b = 0; b < own_bits; ++b)
+            {
+                const uint32_t bit = (v >> b) & 1u;
+                code |= b < shared ? bit << (2 * b + offset) : bit << (2 * shared + (b - shared));
+            }
+            return code;
+        }
+
+        /// @brief 8 个字节各自是否非零, 压成 8 位
+        uint8_t NonZeroBits(const unsigned char *bytes)
+        {
+            uint64_t v;
+            std::memcpy(&v, bytes, sizeof(v));
+            const uint64_t low7 = 0x7F7F7F7F7F7F7F7Full;
+            const uint64_t high = (((v & low7) + low7) | v) & 0x8080808080808080ull;
+            return static_cast<uint8_t>((high * 0x0002040810204081ull) >> 56);
+        }
+    }
+
+    void BitGrid::Build(const xviz::GridMap &map)
+    {
+        Reset(GridWidth(map), GridHeight(map));
+        m_layout = map;
+        m_layout.m_data = nullptr;
+
+        for (int y = 0; y < m_height; ++y)
+        {
+            const unsigned char *row = map.m_data + static_cast<size_t>(y) * m_width;
+            const int shift = (y & (kTileSize - 1)) << kTileShift;
+            for (int tx = 0; tx < m_tilesX; ++tx)
+            {
+                const int x0 = tx << kTileShift;
+                uint64_t bits = 0;
+                if (x0 + kTileSize <= m_width)
+                {
+                    bits = NonZeroBits(row + x0);
+                }
+                else
+                {
+                    for (int x = x0; x < m_width; ++x)
+                    {
+                        bits |= static_cast<uint64_t>(IsOccupiedValue(row[x]) ? 1 : 0) << (x - x0);
+                    }
+                }
+                TileRef(tx, y >> kTileShift) |= bits << shift;
+            }
+        }
+    }
+
+    void BitGrid::Reset(const int width, const int height)
+    {
+        m_layout = xviz::GridMap();
+        m_layout.m_data = nullptr;
+        m_width = std::max(0, width);
+        m_height = std::max(0, height);
+        m_tilesX = (m_width + kTileSize - 1) >> kTileShift;
+        m_tilesY = (m_height + kTileSize - 1) >> kTileShift;
+        const int bits_x = CeilLog2(std::max(1, m_tilesX));
+        const int bits_y = CeilLog2(std::max(1, m_tilesY));
+        m_xCode.resize(m_tilesX);
+        m_yCode.resize(m_tilesY);
+        for (int tx = 0; tx < m_tilesX; ++tx)
+        {
+            m_xCode[tx] = Spread(tx, bits_x, bits_y, 0);
+        }
+        for (int ty = 0; ty < m_tilesY; ++ty)
+        {
+            m_yCode[ty] = Spread(ty, bits_y, bits_x, 1);
+        }
+        m_tiles.assign(static_cast<size_t>(1) << (bits_x + bits_y), 0);
+    }
+
+    void BitGrid::ToGridMap(xviz::GridMap *map, std::vector<unsigned char> *storage,
+                            const unsigned char occupied_value) const
+    {
+        storage->assign(static_cast<size_t>(m_width) * m_height, 0);
+        for (int ty = 0; ty < m_tilesY; ++ty)
+        {
+            for (int tx = 0; tx < m_tilesX; ++tx)
+            {
+                uint64_t word = Tile(tx, ty);
+                while (word != 0)
+                {
+                    const int bit = LowestSetBit(word);
+                    word &= word - 1;
+                    const int x = (tx << kTileShift) | (bit & (kTileSize - 1));
+                    const int y = (ty << kTileShift) | (bit >> kTileShift);
+                    (*storage)[static_cast<size_t>(y) * m_width + x] = occupied_value;
+                }
+            }
+        }
+        *map = m_layout;
+        map->m_data = storage->data();
+    }
+
+    void BitGrid::Set(const int x, const int y, const bool occupied)
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        {
+            return;
+        }
+        const uint64_t bit = 1ull << BitIndex(x, y);
+        uint64_t &tile = TileRef(x >> kTileShift, y >> kTileShift);
+        tile = occupied ? tile | bit : tile & ~bit;
+    }
+
+    bool BitGrid::AnyInBox(const int x0, const int y0, const int x1, const int y1) const
+    {
+        if (x0 < 0 || y0 < 0 || x1 >= m_width || y1 >= m_height)
+        {
+            return true;
+        }
+        const int tx0 = x0 >> kTileShift, tx1 = x1 >> kTileShift;
+        const int ty0 = y0 >> kTileShift, ty1 = y1 >> kTileShift;
+        for (int ty = ty0; ty <= ty1; ++ty)
+        {
+            const int ly0 = ty == ty0 ? y0 & (kTileSize - 1) : 0;
+            const int ly1 = ty == ty1 ? y1 & (kTileSize - 1) : kTileSize - 1;
+            for (int tx = tx0; tx <= tx1; ++tx)
+            {
+                const int lx0 = tx == tx0 ? x0 & (kTileSize - 1) : 0;
+                const int lx1 = tx == tx1 ? x1 & (kTileSize - 1) : kTileSize - 1;
+                if (Tile(tx, ty) & BoxMask(lx0, lx1, ly0, ly1))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,111 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-25 19:36:21
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-25 19:36:21
+ */
+
+#ifndef __BIT_GRID_H__
+#define __BIT_GRID_H__
+
+#include "data_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace auto_parking_planning
+{
+    /// @brief 最低置位的位序号, word 不能为 0
+    inline int LowestSetBit(const uint64_t word)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    /// @brief 每格 1 位的占据栅格. 8x8 栅格组成一块, 存为一个 64 位字, 第 (y & 7) 个字节的
+    /// 第 (x & 7) 位对应栅格 (x, y); 块按 Morton(Z) 序排列, 相邻块在内存中也相邻,
+    /// 车体大小的区域只涉及少量缓存行
+    class BitGrid
+    {
+    public:
+        static constexpr int kTileShift = 3;
+        static constexpr int kTileSize = 1 << kTileShift;
+
+        /// @brief 由 GridMap 构建, 非零值为占据
+        void Build(const xviz::GridMap &map);
+
+        /// @brief 按栅格尺寸分配全空的栅格
+        void Reset(const int width, const int height);
+
+        /// @brief 转回行优先的 GridMap, 占据栅格写 occupied_value, 数据存于 storage
+        void ToGridMap(xviz::GridMap *map, std::vector<unsigned char> *storage,
+                       const unsigned char occupied_value = 100) const;
+
+        int Width() const { return m_width; }
+
+        int Height() const { return m_height; }
+
+        /// @brief 越界视为占据
+        bool Occupied(const int x, const int y) const
+        {
+            if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            {
+                return true;
+            }
+            return (Tile(x >> kTileShift, y >> kTileShift) >> BitIndex(x, y)) & 1u;
+        }
+
+        void Set(const int x, const int y, const bool occupied);
+
+        /// @brief 闭区间 [x0, x1] x [y0, y1] 内是否有占据栅格, 按块整字判断; 超出地图的部分视为占据
+        bool AnyInBox(const int x0, const int y0, const int x1, const int y1) const;
+
+        /// @brief 第 (tx, ty) 块的 64 位占据字
+        uint64_t Tile(const int tx, const int ty) const { return m_tiles[m_xCode[tx] | m_yCode[ty]]; }
+
+        int TilesX() const { return m_tilesX; }
+
+        int TilesY() const { return m_tilesY; }
+
+        /// @brief 块内闭区间 [x0, x1] x [y0, y1] (0..7) 的位掩码
+        static uint64_t BoxMask(const int x0, const int x1, const int y0, const int y1)
+        {
+            const uint64_t row = (0xFFull >> (7 - (x1 - x0))) << x0;
+            const uint64_t rows = (~0ull >> (8 * (7 - (y1 - y0)))) << (8 * y0);
+            return (row * 0x0101010101010101ull) & rows;
+        }
+
+        static int BitIndex(const int x, const int y)
+        {
+            return ((y & (kTileSize - 1)) << kTileShift) | (x & (kTileSize - 1));
+        }
+
+        size_t MemoryBytes() const { return m_tiles.size() * sizeof(uint64_t); }
+
+    private:
+        uint64_t &TileRef(const int tx, const int ty) { return m_tiles[m_xCode[tx] | m_yCode[ty]]; }
+
+    private:
+        int m_width = 0;
+        int m_height = 0;
+        int m_tilesX = 0;
+        int m_tilesY = 0;
+        /// 块坐标到 Morton 序号的按位展开表, 序号为 m_xCode[tx] | m_yCode[ty]
+        std::vector<uint32_t> m_xCode;
+        std::vector<uint32_t> m_yCode;
+        std::vector<uint64_t> m_tiles;
+        /// 除数据指针外的地图参数, 转回 GridMap 时使用
+        xviz::GridMap m_layout;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __BIT_GRID_H__ */
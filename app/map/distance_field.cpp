@@ -0,0 +1,292 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 20:31:27
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 20:31:27
+ */
+#include "distance_field.h"
+#include "grid_map_utils.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kInf = 1e20f;
+        constexpr int32_t kNoSite = -1;
+        constexpr int32_t kFar = std::numeric_limits<int32_t>::max();
+
+        /// Felzenszwalb 一维平方距离变换, f 为输入代价, d 为输出, arg 为取得最小值的下标
+        void DistanceTransform1D(const float *f, const int n, float *d, int *arg, int *v, float *z)
+        {
+            int k = 0;
+            v[0] = 0;
+            z[0] = -kInf;
+            z[1] = kInf;
+            for (int q = 1; q < n; ++q)
+            {
+                float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+                while (s <= z[k])
+                {
+                    --k;
+                    s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+                }
+                ++k;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = kInf;
+            }
+            k = 0;
+            for (int q = 0; q < n; ++q)
+            {
+                while (z[k + 1] < q)
+                {
+                    ++k;
+                }
+                d[q] = Square(q - v[k]) + f[v[k]];
+                arg[q] = v[k];
+            }
+        }
+    }
+
+    void DistanceField::Build(const xviz::GridMap &map)
+    {
+        m_width = GridWidth(map);
+        m_height = GridHeight(map);
+        m_res = map.m_res;
+        const size_t cells = GridCellCount(map);
+        m_data.assign(cells, kInf);
+        for (size_t i = 0; i < cells; ++i)
+        {
+            if (IsOccupiedValue(map.m_data[i]))
+            {
+                m_data[i] = 0.0f;
+            }
+        }
+        // 最近占据栅格推迟到第一次增量更新时再求, 不增加只做重建时的开销
+        m_site.clear();
+        m_sqDist.clear();
+        Transform(false);
+    }
+
+    void DistanceField::Transform(const bool track_sites)
+    {
+        if (m_data.empty())
+        {
+            return;
+        }
+        const int n = std::max(m_width, m_height);
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n), arg(n), row_sites(track_sites ? n : 0);
+
+        // 先沿列变换, 求最近占据栅格时 m_site 暂存同列最近占据栅格的行号
+        for (int x = 0; x < m_width; ++x)
+        {
+            for (int y = 0; y < m_height; ++y)
+            {
+                f[y] = m_data[static_cast<size_t>(y) * m_width + x];
+            }
+            DistanceTransform1D(f.data(), m_height, d.data(), arg.data(), v.data(), z.data());
+            for (int y = 0; y < m_height; ++y)
+            {
+                const size_t i = static_cast<size_t>(y) * m_width + x;
+                m_data[i] = d[y];
+                if (track_sites)
+                {
+                    m_site[i] = d[y] < 0.5f * kInf ? arg[y] : kNoSite;
+                }
+            }
+        }
+        // 再沿行变换, 并与地图边界距离取小
+        for (int y = 0; y < m_height; ++y)
+        {
+            float *row = m_data.data() + static_cast<size_t>(y) * m_width;
+            DistanceTransform1D(row, m_width, d.data(), arg.data(), v.data(), z.data());
+            if (track_sites)
+            {
+                const size_t offset = static_cast<size_t>(y) * m_width;
+                std::copy(m_site.begin() + offset, m_site.begin() + offset + m_width, row_sites.begin());
+                for (int x = 0; x < m_width; ++x)
+                {
+                    const int sx = arg[x];
+                    const int sy = row_sites[sx];
+                    const bool found = d[x] < 0.5f * kInf && sy != kNoSite;
+                    m_site[offset + x] = found ? sy * m_width + sx : kNoSite;
+                    m_sqDist[offset + x] = found ? Square(x - sx) + Square(y - sy) : kFar;
+                    Refresh(static_cast<uint32_t>(offset + x));
+                }
+                continue;
+            }
+            const float border_y = std::min(y + 0.5f, m_height - y - 0.5f);
+            for (int x = 0; x < m_width; ++x)
+            {
+                const float border = std::min(border_y, std::min(x + 0.5f, m_width - x - 0.5f));
+                row[x] = std::min(std::sqrt(d[x]), border) * m_res;
+            }
+        }
+    }
+
+    void DistanceField::BuildSites()
+    {
+        // 占据栅格的距离恰为 0, 其余栅格至少为半格到边界的距离
+        const size_t cells = m_data.size();
+        for (size_t i = 0; i < cells; ++i)
+        {
+            m_data[i] = m_data[i] == 0.0f ? 0.0f : kInf;
+        }
+        m_site.assign(cells, kNoSite);
+        m_sqDist.assign(cells, kFar);
+        m_raise.assign(cells, 0);
+        Transform(true);
+    }
+
+    size_t DistanceField::Update(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed)
+    {
+        if (m_data.empty())
+        {
+            return 0;
+        }
+        if (m_site.size() != m_data.size())
+        {
+            BuildSites();
+        }
+        m_open.clear();
+        for (const xviz::Vec2i &cell : freed)
+        {
+            if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || cell.y >= m_height)
+            {
+                continue;
+            }
+            const uint32_t i = static_cast<uint32_t>(cell.y) * m_width + cell.x;
+            if (!IsSite(static_cast<int32_t>(i)))
+            {
+                continue;
+            }
+            m_site[i] = kNoSite;
+            m_sqDist[i] = kFar;
+            m_raise[i] = 1;
+            Refresh(i);
+            Push(0, i);
+        }
+        for (const xviz::Vec2i &cell : occupied)
+        {
+            if (cell.x < 0 || cell.y < 0 || cell.x >= m_width || cell.y >= m_height)
+            {
+                continue;
+            }
+            const uint32_t i = static_cast<uint32_t>(cell.y) * m_width + cell.x;
+            if (IsSite(static_cast<int32_t>(i)))
+            {
+                continue;
+            }
+            m_site[i] = static_cast<int32_t>(i);
+            m_sqDist[i] = 0;
+            m_raise[i] = 0;
+            Refresh(i);
+            Push(0, i);
+        }
+
+        // 按键值从小到大处理, 升高波先于同距离的降低波到达
+        size_t processed = 0;
+        while (!m_open.empty())
+        {
+            std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenEntry>());
+            const OpenEntry entry = m_open.back();
+            m_open.pop_back();
+            ++processed;
+            if (m_raise[entry.cell])
+            {
+                Raise(entry.cell);
+            }
+            else if (entry.key == m_sqDist[entry.cell] && IsSite(m_site[entry.cell]))
+            {
+                // 同一栅格可能被多次压入, 只处理与当前距离一致的一次
+                Lower(entry.cell);
+            }
+        }
+        return processed;
+    }
+
+    void DistanceField::Push(const int32_t key, const uint32_t cell)
+    {
+        m_open.push_back({key, cell});
+        std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenEntry>());
+    }
+
+    void DistanceField::Refresh(const uint32_t cell)
+    {
+        const int x = static_cast<int>(cell % m_width);
+        const int y = static_cast<int>(cell / m_width);
+        const float border =
+            std::min(std::min(x + 0.5f, m_width - x - 0.5f), std::min(y + 0.5f, m_height - y - 0.5f));
+        const float distance =
+            m_sqDist[cell] == kFar ? border : std::min(std::sqrt(static_cast<float>(m_sqDist[cell])), border);
+        m_data[cell] = distance * m_res;
+    }
+
+    void DistanceField::Raise(const uint32_t cell)
+    {
+        const int x = static_cast<int>(cell % m_width);
+        const int y = static_cast<int>(cell / m_width);
+        for (int ny = std::max(0, y - 1); ny <= std::min(m_height - 1, y + 1); ++ny)
+        {
+            for (int nx = std::max(0, x - 1); nx <= std::min(m_width - 1, x + 1); ++nx)
+            {
+                const uint32_t n = static_cast<uint32_t>(ny) * m_width + nx;
+                if (n == cell || m_site[n] == kNoSite || m_raise[n])
+                {
+                    continue;
+                }
+                if (!IsSite(m_site[n]))
+                {
+                    // 最近障碍物已释放, 清除并继续传播升高波
+                    const int32_t previous = m_sqDist[n];
+                    m_site[n] = kNoSite;
+                    m_sqDist[n] = kFar;
+                    m_raise[n] = 1;
+                    Refresh(n);
+                    Push(previous, n);
+                }
+                else
+                {
+                    // 升高波的边界, 由它重新向清除区域传播降低波
+                    Push(m_sqDist[n], n);
+                }
+            }
+        }
+        m_raise[cell] = 0;
+    }
+
+    void DistanceField::Lower(const uint32_t cell)
+    {
+        const int x = static_cast<int>(cell % m_width);
+        const int y = static_cast<int>(cell / m_width);
+        const int32_t site = m_site[cell];
+        const int sx = site % m_width;
+        const int sy = site / m_width;
+        for (int ny = std::max(0, y - 1); ny <= std::min(m_height - 1, y + 1); ++ny)
+        {
+            for (int nx = std::max(0, x - 1); nx <= std::min(m_width - 1, x + 1); ++nx)
+            {
+                const uint32_t n = static_cast<uint32_t>(ny) * m_width + nx;
+                if (m_raise[n])
+                {
+                    continue;
+                }
+                const int32_t sq_dist = Square(nx - sx) + Square(ny - sy);
+                if (sq_dist < m_sqDist[n])
+                {
+                    m_site[n] = site;
+                    m_sqDist[n] = sq_dist;
+                    Refresh(n);
+                    Push(sq_dist, n);
+                }
+            }
+        }
+    }
+
+} // namespace auto_parking_planning
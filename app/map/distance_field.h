@@ -0,0 +1,92 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 20:18:09
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 20:18:09
+ */
+
+#ifndef __DISTANCE_FIELD_H__
+#define __DISTANCE_FIELD_H__
+
+#include "common/span.h"
+#include "data_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 栅格欧氏距离场, 每个栅格存储到最近占据栅格(或地图边界)的距离, 单位米.
+    /// 同时记录每个栅格最近的占据栅格, 障碍物局部变化时可增量更新
+    class DistanceField
+    {
+    public:
+        /// @brief 全图重建, 复杂度 O(栅格数)
+        void Build(const xviz::GridMap &map);
+
+        /// @brief 动态 brushfire 增量更新: 释放的占据栅格向外传播升高波, 清除以其为最近障碍物的栅格,
+        /// 新占据栅格与升高波边界向外传播降低波. 代价与距离发生变化的区域成正比;
+        /// 结果为到某个占据栅格的距离, 与 Build 相比个别栅格可能略大.
+        /// Build 后第一次调用时先求各栅格的最近占据栅格, 代价同一次重建. 返回处理的栅格数
+        size_t Update(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed);
+
+        int Width() const { return m_width; }
+
+        int Height() const { return m_height; }
+
+        float Resolution() const { return m_res; }
+
+        /// @brief 栅格坐标处的距离, 越界返回 0
+        float Distance(const int gx, const int gy) const
+        {
+            if (gx < 0 || gy < 0 || gx >= m_width || gy >= m_height)
+            {
+                return 0.0f;
+            }
+            return m_data[static_cast<size_t>(gy) * m_width + gx];
+        }
+
+        const float *Data() const { return m_data.data(); }
+
+    private:
+        struct OpenEntry
+        {
+            /// 降低波为当前平方距离, 升高波为清除前的平方距离
+            int32_t key;
+            uint32_t cell;
+
+            bool operator>(const OpenEntry &other) const { return key > other.key; }
+        };
+
+        /// @brief 两遍一维距离变换, m_data 输入为 0(占据)或无穷大; track_sites 时同时求最近占据栅格
+        void Transform(const bool track_sites);
+
+        void BuildSites();
+
+        void Push(const int32_t key, const uint32_t cell);
+
+        /// @brief 由平方距离与地图边界距离刷新输出
+        void Refresh(const uint32_t cell);
+
+        bool IsSite(const int32_t site) const { return site >= 0 && m_site[site] == site; }
+
+        void Raise(const uint32_t cell);
+
+        void Lower(const uint32_t cell);
+
+    private:
+        int m_width = 0;
+        int m_height = 0;
+        float m_res = 1.0f;
+        std::vector<float> m_data;
+        /// 最近占据栅格的下标(无则为 -1)及到它的平方距离(单位: 格), 只在增量更新后有效
+        std::vector<int32_t> m_site;
+        std::vector<int32_t> m_sqDist;
+        /// 增量更新的工作区, 在多次更新间复用
+        std::vector<uint8_t> m_raise;
+        std::vector<OpenEntry> m_open;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __DISTANCE_FIELD_H__ */
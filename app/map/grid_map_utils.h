@@ -0,0 +1,68 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 21:02:15
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 21:02:15
+ */
+
+#ifndef __GRID_MAP_UTILS_H__
+#define __GRID_MAP_UTILS_H__
+
+#include "data_types.h"
+#include <cmath>
+#include <cstddef>
+
+namespace auto_parking_planning
+{
+    // xviz::GridMap 约定: m_size 为栅格数(x 为列数, y 为行数), 数据按行优先存储,
+    // m_origin/m_originYaw 为栅格(0, 0)角点在世界系下的位姿, 非零值表示占据
+
+    inline int GridWidth(const xviz::GridMap &map) { return static_cast<int>(map.m_size.x); }
+
+    inline int GridHeight(const xviz::GridMap &map) { return static_cast<int>(map.m_size.y); }
+
+    inline size_t GridCellCount(const xviz::GridMap &map)
+    {
+        return static_cast<size_t>(GridWidth(map)) * static_cast<size_t>(GridHeight(map));
+    }
+
+    inline bool IsOccupiedValue(const unsigned char value) { return value != 0; }
+
+    /// @brief 世界坐标转连续栅格坐标(单位: 格)
+    inline void WorldToGrid(const xviz::GridMap &map, const float x, const float y,
+                            float *gx, float *gy)
+    {
+        const float dx = x - map.m_origin.x;
+        const float dy = y - map.m_origin.y;
+        if (map.m_originYaw == 0.0f)
+        {
+            *gx = dx / map.m_res;
+            *gy = dy / map.m_res;
+            return;
+        }
+        const float c = cosf(map.m_originYaw);
+        const float s = sinf(map.m_originYaw);
+        *gx = (c * dx + s * dy) / map.m_res;
+        *gy = (-s * dx + c * dy) / map.m_res;
+    }
+
+    /// @brief 栅格中心转世界坐标
+    inline void GridToWorld(const xviz::GridMap &map, const int gx, const int gy,
+                            float *x, float *y)
+    {
+        const float lx = (static_cast<float>(gx) + 0.5f) * map.m_res;
+        const float ly = (static_cast<float>(gy) + 0.5f) * map.m_res;
+        const float c = cosf(map.m_originYaw);
+        const float s = sinf(map.m_originYaw);
+        *x = map.m_origin.x + c * lx - s * ly;
+        *y = map.m_origin.y + s * lx + c * ly;
+    }
+
+    inline bool IsInside(const xviz::GridMap &map, const int gx, const int gy)
+    {
+        return gx >= 0 && gy >= 0 && gx < GridWidth(map) && gy < GridHeight(map);
+    }
+
+} // namespace auto_parking_planning
+
+#endif /* __GRID_MAP_UTILS_H__ */
@@ -0,0 +1,84 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-26 20:14:08
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-26 20:14:08
+ */
+#include "occupancy_pyramid.h"
+#include <algorithm>
+
+namespace auto_parking_planning
+{
+    void OccupancyPyramid::Build(const xviz::GridMap &map)
+    {
+        m_levels.resize(1);
+        m_levels[0].Build(map);
+        while (m_levels.back().Width() > 1 || m_levels.back().Height() > 1)
+        {
+            const BitGrid &fine = m_levels.back();
+            BitGrid coarse;
+            coarse.Reset((fine.Width() + 1) >> 1, (fine.Height() + 1) >> 1);
+            // 只遍历置位的栅格, 稀疏地图上代价与障碍物数量成正比
+            for (int ty = 0; ty < fine.TilesY(); ++ty)
+            {
+                for (int tx = 0; tx < fine.TilesX(); ++tx)
+                {
+                    uint64_t word = fine.Tile(tx, ty);
+                    while (word != 0)
+                    {
+                        const int bit = LowestSetBit(word);
+                        word &= word - 1;
+                        const int x = (tx << BitGrid::kTileShift) | (bit & (BitGrid::kTileSize - 1));
+                        const int y = (ty << BitGrid::kTileShift) | (bit >> BitGrid::kTileShift);
+                        coarse.Set(x >> 1, y >> 1, true);
+                    }
+                }
+            }
+            m_levels.push_back(std::move(coarse));
+        }
+    }
+
+    void OccupancyPyramid::Set(const int x, const int y, const bool occupied)
+    {
+        if (m_levels.empty() || x < 0 || y < 0 || x >= m_levels[0].Width() || y >= m_levels[0].Height())
+        {
+            return;
+        }
+        if (m_levels[0].Occupied(x, y) == occupied)
+        {
+            return;
+        }
+        m_levels[0].Set(x, y, occupied);
+        for (int level = 1; level < Levels(); ++level)
+        {
+            const int px = x >> level;
+            const int py = y >> level;
+            // 置位时父栅格必然占据; 清除时需看其余子栅格
+            const bool value = occupied || Pool(level, px, py);
+            if (m_levels[level].Occupied(px, py) == value)
+            {
+                break;
+            }
+            m_levels[level].Set(px, py, value);
+        }
+    }
+
+    size_t OccupancyPyramid::MemoryBytes() const
+    {
+        size_t bytes = 0;
+        for (const BitGrid &level : m_levels)
+        {
+            bytes += level.MemoryBytes();
+        }
+        return bytes;
+    }
+
+    bool OccupancyPyramid::Pool(const int level, const int x, const int y) const
+    {
+        const BitGrid &fine = m_levels[level - 1];
+        const int x1 = std::min(2 * x + 1, fine.Width() - 1);
+        const int y1 = std::min(2 * y + 1, fine.Height() - 1);
+        return fine.AnyInBox(2 * x, 2 * y, x1, y1);
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,49 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-26 19:52:40
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-26 19:52:40
+ */
+
+#ifndef __OCCUPANCY_PYRAMID_H__
+#define __OCCUPANCY_PYRAMID_H__
+
+#include "bit_grid.h"
+#include "data_types.h"
+#include <cstddef>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 占据栅格的最大池化金字塔. 第 0 层为原始分辨率, 第 k 层的栅格 (x, y) 覆盖
+    /// 第 0 层 [x << k, (x + 1) << k) x [y << k, (y + 1) << k) 的区域, 区域内有占据即为占据;
+    /// 逐层减半直到只剩一个栅格
+    class OccupancyPyramid
+    {
+    public:
+        /// @brief 由 GridMap 构建全部层, 非零值为占据
+        void Build(const xviz::GridMap &map);
+
+        /// @brief 更新第 0 层的一个栅格, 只沿父栅格向上传播到结果不再变化的一层
+        void Set(const int x, const int y, const bool occupied);
+
+        int Levels() const { return static_cast<int>(m_levels.size()); }
+
+        const BitGrid &Level(const int level) const { return m_levels[level]; }
+
+        /// @brief 第 level 层的栅格是否占据, 越界视为占据
+        bool Occupied(const int level, const int x, const int y) const { return m_levels[level].Occupied(x, y); }
+
+        size_t MemoryBytes() const;
+
+    private:
+        /// @brief 由第 level - 1 层重新计算第 level 层栅格 (x, y)
+        bool Pool(const int level, const int x, const int y) const;
+
+    private:
+        std::vector<BitGrid> m_levels;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __OCCUPANCY_PYRAMID_H__ */
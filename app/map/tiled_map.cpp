@@ -0,0 +1,328 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-27 20:22:57
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-27 20:22:57
+ */
+#include "tiled_map.h"
+#include "grid_map_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        /// 预取线程空闲时单次等待的最长时间; 新请求与 Close 都会立即唤醒, 超时只是兜底
+        constexpr auto kIdleWait = std::chrono::milliseconds(100);
+        constexpr size_t kTouchStride = 4096;
+
+        uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    TiledMap::~TiledMap() { Close(); }
+
+    bool TiledMap::Write(const xviz::GridMap &map, const int tile_size, const std::string &path)
+    {
+        const int width = GridWidth(map);
+        const int height = GridHeight(map);
+        if (tile_size <= 0 || width <= 0 || height <= 0 || map.m_data == nullptr || map.m_res <= 0.0f)
+        {
+            return false;
+        }
+
+        TiledMapHeader header = {};
+        std::memcpy(header.magic, kTiledMapMagic, sizeof(header.magic));
+        header.version = kTiledMapVersion;
+        header.headerSize = sizeof(TiledMapHeader);
+        header.width = static_cast<uint32_t>(width);
+        header.height = static_cast<uint32_t>(height);
+        header.tileSize = static_cast<uint32_t>(tile_size);
+        header.tilesX = static_cast<uint32_t>((width + tile_size - 1) / tile_size);
+        header.tilesY = static_cast<uint32_t>((height + tile_size - 1) / tile_size);
+        header.resolution = map.m_res;
+        header.originX = map.m_origin.x;
+        header.originY = map.m_origin.y;
+        header.originYaw = map.m_originYaw;
+        header.dataOffset = AlignUp(sizeof(TiledMapHeader), kTiledMapAlignment);
+        header.tileStride = AlignUp(static_cast<uint64_t>(tile_size) * tile_size, kTiledMapAlignment);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        const std::vector<char> padding(header.dataOffset - sizeof(header), 0);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        std::vector<unsigned char> tile(header.tileStride);
+        for (uint32_t ty = 0; ty < header.tilesY; ++ty)
+        {
+            for (uint32_t tx = 0; tx < header.tilesX; ++tx)
+            {
+                std::fill(tile.begin(), tile.end(), 0);
+                const int x0 = static_cast<int>(tx) * tile_size;
+                const int y0 = static_cast<int>(ty) * tile_size;
+                const int cols = std::min(tile_size, width - x0);
+                const int rows = std::min(tile_size, height - y0);
+                for (int j = 0; j < rows; ++j)
+                {
+                    std::memcpy(tile.data() + static_cast<size_t>(j) * tile_size,
+                                map.m_data + static_cast<size_t>(y0 + j) * width + x0, cols);
+                }
+                out.write(reinterpret_cast<const char *>(tile.data()), static_cast<std::streamsize>(tile.size()));
+            }
+        }
+        return out.good();
+    }
+
+    bool TiledMap::Open(const std::string &path, const TiledMapConfig &config)
+    {
+        Close();
+        if (!m_file.Open(path) || m_file.Size() < sizeof(TiledMapHeader))
+        {
+            Close();
+            return false;
+        }
+        std::memcpy(&m_header, m_file.Data(), sizeof(m_header));
+        const TiledMapHeader &h = m_header;
+        const uint64_t tiles = static_cast<uint64_t>(h.tilesX) * h.tilesY;
+        if (std::memcmp(h.magic, kTiledMapMagic, sizeof(h.magic)) != 0 || h.version != kTiledMapVersion ||
+            h.headerSize != sizeof(TiledMapHeader) || h.tileSize == 0 || h.width == 0 || h.height == 0 ||
+            h.resolution <= 0.0f || h.tilesX != (h.width + h.tileSize - 1) / h.tileSize ||
+            h.tilesY != (h.height + h.tileSize - 1) / h.tileSize ||
+            h.tileStride < static_cast<uint64_t>(h.tileSize) * h.tileSize || h.dataOffset > m_file.Size() ||
+            tiles * h.tileStride > m_file.Size() - h.dataOffset)
+        {
+            Close();
+            return false;
+        }
+        // 块未按页对齐时淘汰无法释放页面, 常驻内存会随访问过的范围增长
+        if (h.dataOffset % kTiledMapAlignment != 0 || h.tileStride % kTiledMapAlignment != 0 ||
+            kTiledMapAlignment % MappedFile::PageSize() != 0)
+        {
+            Close();
+            return false;
+        }
+
+        m_layout = xviz::GridMap();
+        m_layout.m_data = nullptr;
+        m_layout.m_res = h.resolution;
+        m_layout.m_origin = xviz::Vec2f(h.originX, h.originY);
+        m_layout.m_size = xviz::Vec2f(static_cast<float>(h.width), static_cast<float>(h.height));
+        m_layout.m_originYaw = h.originYaw;
+        m_config = config;
+        m_running = true;
+        m_prefetcher = std::thread(&TiledMap::PrefetchLoop, this);
+        return true;
+    }
+
+    void TiledMap::Close()
+    {
+        if (m_running.exchange(false))
+        {
+            m_prefetch.Interrupt();
+            if (m_prefetcher.joinable())
+            {
+                m_prefetcher.join();
+            }
+            // 丢弃未处理的请求, 避免重新打开后调入旧文件的块号
+            std::vector<uint32_t> stale;
+            m_prefetch.Take(&stale);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lru.clear();
+            m_resident.clear();
+            m_stats = TiledMapStats();
+        }
+        m_file.Close();
+        m_header = TiledMapHeader();
+    }
+
+    bool TiledMap::Window(const float x, const float y, const float size, xviz::GridMap *map,
+                          std::vector<unsigned char> *storage)
+    {
+        if (!IsOpen())
+        {
+            return false;
+        }
+        float gx, gy;
+        WorldToGrid(m_layout, x, y, &gx, &gy);
+        const float half = 0.5f * size / m_header.resolution;
+        const int width = static_cast<int>(m_header.width);
+        const int height = static_cast<int>(m_header.height);
+        const int i0 = std::max(0, static_cast<int>(std::floor(gx - half)));
+        const int j0 = std::max(0, static_cast<int>(std::floor(gy - half)));
+        const int i1 = std::min(width, static_cast<int>(std::ceil(gx + half)));
+        const int j1 = std::min(height, static_cast<int>(std::ceil(gy + half)));
+        if (i0 >= i1 || j0 >= j1)
+        {
+            return false;
+        }
+
+        const int cols = i1 - i0;
+        const int tile_size = static_cast<int>(m_header.tileSize);
+        storage->assign(static_cast<size_t>(cols) * (j1 - j0), 0);
+        for (int ty = j0 / tile_size; ty <= (j1 - 1) / tile_size; ++ty)
+        {
+            const int ya = std::max(j0, ty * tile_size);
+            const int yb = std::min(j1, (ty + 1) * tile_size);
+            for (int tx = i0 / tile_size; tx <= (i1 - 1) / tile_size; ++tx)
+            {
+                const int xa = std::max(i0, tx * tile_size);
+                const int xb = std::min(i1, (tx + 1) * tile_size);
+                const unsigned char *tile = Acquire(static_cast<uint32_t>(ty) * m_header.tilesX + tx, false);
+                for (int j = ya; j < yb; ++j)
+                {
+                    std::memcpy(storage->data() + static_cast<size_t>(j - j0) * cols + (xa - i0),
+                                tile + static_cast<size_t>(j - ty * tile_size) * tile_size + (xa - tx * tile_size),
+                                xb - xa);
+                }
+            }
+        }
+
+        *map = m_layout;
+        map->m_size = xviz::Vec2f(static_cast<float>(cols), static_cast<float>(j1 - j0));
+        const float c = cosf(m_layout.m_originYaw);
+        const float s = sinf(m_layout.m_originYaw);
+        const float lx = i0 * m_header.resolution;
+        const float ly = j0 * m_header.resolution;
+        map->m_origin = xviz::Vec2f(m_layout.m_origin.x + c * lx - s * ly, m_layout.m_origin.y + s * lx + c * ly);
+        map->m_data = storage->data();
+        return true;
+    }
+
+    void TiledMap::Prefetch(const std::vector<xviz::Vec2f> &points, const float radius)
+    {
+        if (!IsOpen())
+        {
+            return;
+        }
+        // 按路径顺序收集块, 近处的先调入; 超过缓存容量的部分调入后也会被淘汰, 不再请求
+        const size_t capacity = static_cast<size_t>(std::max(1, m_config.cacheTiles));
+        const float reach = radius / m_header.resolution;
+        const int tile_size = static_cast<int>(m_header.tileSize);
+        const int last_x = static_cast<int>(m_header.tilesX) - 1;
+        const int last_y = static_cast<int>(m_header.tilesY) - 1;
+        std::vector<uint32_t> tiles;
+        std::unordered_set<uint32_t> seen;
+        for (const xviz::Vec2f &pt : points)
+        {
+            float gx, gy;
+            WorldToGrid(m_layout, pt.x, pt.y, &gx, &gy);
+            const int tx0 = std::max(0, static_cast<int>(std::floor((gx - reach) / tile_size)));
+            const int ty0 = std::max(0, static_cast<int>(std::floor((gy - reach) / tile_size)));
+            const int tx1 = std::min(last_x, static_cast<int>(std::floor((gx + reach) / tile_size)));
+            const int ty1 = std::min(last_y, static_cast<int>(std::floor((gy + reach) / tile_size)));
+            for (int ty = ty0; ty <= ty1 && tiles.size() < capacity; ++ty)
+            {
+                for (int tx = tx0; tx <= tx1 && tiles.size() < capacity; ++tx)
+                {
+                    const uint32_t tile = static_cast<uint32_t>(ty) * m_header.tilesX + tx;
+                    if (seen.insert(tile).second)
+                    {
+                        tiles.push_back(tile);
+                    }
+                }
+            }
+        }
+        if (!tiles.empty())
+        {
+            m_prefetch.Post(tiles);
+        }
+    }
+
+    TiledMapStats TiledMap::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TiledMapStats stats = m_stats;
+        stats.residentTiles = m_lru.size();
+        stats.residentBytes = m_lru.size() * static_cast<size_t>(m_header.tileSize) * m_header.tileSize;
+        return stats;
+    }
+
+    const unsigned char *TiledMap::Acquire(const uint32_t tile, const bool prefetch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_resident.find(tile);
+            if (it != m_resident.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                m_stats.hits += prefetch ? 0 : 1;
+                return TileData(tile);
+            }
+        }
+        // 调入不持锁; 取窗口时由随后的拷贝触发缺页, 不必预先读取
+        if (prefetch)
+        {
+            Touch(tile);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_resident.find(tile);
+        if (it != m_resident.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return TileData(tile);
+        }
+        m_lru.push_front(tile);
+        m_resident[tile] = m_lru.begin();
+        (prefetch ? m_stats.prefetched : m_stats.loads) += 1;
+        Trim();
+        return TileData(tile);
+    }
+
+    void TiledMap::Touch(const uint32_t tile) const
+    {
+        const size_t offset = m_header.dataOffset + tile * m_header.tileStride;
+        const size_t bytes = static_cast<size_t>(m_header.tileSize) * m_header.tileSize;
+        m_file.WillNeed(offset, bytes);
+        const volatile unsigned char *data = TileData(tile);
+        unsigned char sum = 0;
+        for (size_t i = 0; i < bytes; i += kTouchStride)
+        {
+            sum ^= data[i];
+        }
+        (void)sum;
+    }
+
+    void TiledMap::Trim()
+    {
+        const size_t capacity = static_cast<size_t>(std::max(1, m_config.cacheTiles));
+        while (m_lru.size() > capacity)
+        {
+            const uint32_t tile = m_lru.back();
+            m_lru.pop_back();
+            m_resident.erase(tile);
+            m_file.DontNeed(m_header.dataOffset + tile * m_header.tileStride, m_header.tileStride);
+            ++m_stats.evictions;
+        }
+    }
+
+    void TiledMap::PrefetchLoop()
+    {
+        std::vector<uint32_t> tiles;
+        while (m_running)
+        {
+            if (!m_prefetch.WaitFor(kIdleWait, &tiles))
+            {
+                continue;
+            }
+            for (const uint32_t tile : tiles)
+            {
+                // 有更新的请求时放弃本次剩余的块
+                if (!m_running || m_prefetch.HasFresh())
+                {
+                    break;
+                }
+                Acquire(tile, true);
+            }
+        }
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,151 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-27 19:40:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-27 19:40:12
+ */
+
+#ifndef __TILED_MAP_H__
+#define __TILED_MAP_H__
+
+#include "common/latest_mailbox.h"
+#include "common/mapped_file.h"
+#include "data_types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    // 分块地图文件布局(主机字节序):
+    //   TiledMapHeader | 填充 | tile[tilesY][tilesX]
+    // 每块为 tileSize x tileSize 字节的行优先占据值, 超出地图的部分填 0;
+    // 块起点 dataOffset 与块间距 tileStride 都按 kTiledMapAlignment 对齐, 可按块调入与释放页面;
+    // 64 KiB 是 4 KiB、16 KiB(arm64 macOS)与 64 KiB 页大小的公倍数, 也是 Windows 的映射粒度.
+    // 地图参数的约定与 xviz::GridMap 相同
+
+    constexpr char kTiledMapMagic[8] = {'A', 'P', 'P', 'T', 'M', 'A', 'P', 'S'};
+    constexpr uint32_t kTiledMapVersion = 2;
+    constexpr uint64_t kTiledMapAlignment = 64 * 1024;
+
+    struct TiledMapHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t width;
+        uint32_t height;
+        uint32_t tileSize;
+        uint32_t tilesX;
+        uint32_t tilesY;
+        float resolution;
+        float originX;
+        float originY;
+        float originYaw;
+        uint32_t reserved;
+        uint64_t dataOffset;
+        uint64_t tileStride;
+    };
+
+    static_assert(sizeof(TiledMapHeader) == 72, "TiledMapHeader layout changed");
+    static_assert(std::is_trivially_copyable<TiledMapHeader>::value, "header must be POD");
+
+    struct TiledMapConfig
+    {
+        /// 常驻内存的块数上限, 超出时按最近最少使用淘汰
+        int cacheTiles = 64;
+    };
+
+    struct TiledMapStats
+    {
+        /// 取窗口时块已常驻的次数与需要调入的次数
+        uint64_t hits = 0;
+        uint64_t loads = 0;
+        /// 后台预取调入的块数
+        uint64_t prefetched = 0;
+        uint64_t evictions = 0;
+        size_t residentTiles = 0;
+        size_t residentBytes = 0;
+    };
+
+    /// @brief 内存映射的分块地图. 打开时只读取文件头, 块在取窗口或后台预取时按需调入,
+    /// 常驻块数超过上限时释放最近最少使用的块, 常驻内存只与窗口大小和缓存容量有关
+    class TiledMap
+    {
+    public:
+        TiledMap() = default;
+        ~TiledMap();
+
+        TiledMap(const TiledMap &) = delete;
+        TiledMap &operator=(const TiledMap &) = delete;
+
+        /// @brief 离线把整张地图按 tile_size 分块写入 path
+        static bool Write(const xviz::GridMap &map, const int tile_size, const std::string &path);
+
+        /// @brief 映射分块地图并启动预取 IO 线程, 只读取文件头
+        bool Open(const std::string &path, const TiledMapConfig &config = TiledMapConfig());
+
+        void Close();
+
+        bool IsOpen() const { return m_file.IsOpen(); }
+
+        /// @brief 以世界坐标 (x, y) 为中心截取边长 size 米的窗口, 窗口与地图对齐并裁剪到地图范围内.
+        /// 数据拷贝到 storage, 返回的 map 引用 storage; 窗口与地图不相交时返回 false
+        bool Window(const float x, const float y, const float size, xviz::GridMap *map,
+                    std::vector<unsigned char> *storage);
+
+        /// @brief 在预取 IO 线程上调入各点周围 radius 米内的块, 新请求覆盖尚未处理的旧请求. 调用方不等待
+        void Prefetch(const std::vector<xviz::Vec2f> &points, const float radius);
+
+        /// @brief 除数据指针外的整张地图参数
+        const xviz::GridMap &Layout() const { return m_layout; }
+
+        int TileSize() const { return static_cast<int>(m_header.tileSize); }
+
+        TiledMapStats Stats() const;
+
+    private:
+        /// @brief 标记块被使用, 未常驻时调入; 返回块数据
+        const unsigned char *Acquire(const uint32_t tile, const bool prefetch);
+
+        /// @brief 逐页读一次, 使块的页面全部调入
+        void Touch(const uint32_t tile) const;
+
+        /// @brief 持锁调用, 淘汰超出容量的块
+        void Trim();
+
+        const unsigned char *TileData(const uint32_t tile) const
+        {
+            return m_file.Data() + m_header.dataOffset + tile * m_header.tileStride;
+        }
+
+        void PrefetchLoop();
+
+    private:
+        MappedFile m_file;
+        TiledMapHeader m_header = {};
+        xviz::GridMap m_layout = {};
+        TiledMapConfig m_config;
+
+        /// 常驻块按最近使用排列, 表头最新
+        mutable std::mutex m_mutex;
+        std::list<uint32_t> m_lru;
+        std::unordered_map<uint32_t, std::list<uint32_t>::iterator> m_resident;
+        TiledMapStats m_stats;
+
+        LatestMailbox<std::vector<uint32_t>> m_prefetch;
+        /// 调入块会阻塞在磁盘读上, 用独立线程而不占用规划共享的任务调度器
+        std::thread m_prefetcher;
+        std::atomic<bool> m_running{false};
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __TILED_MAP_H__ */
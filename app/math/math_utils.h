@@ -50,7 +50,7 @@ namespace auto_parking_planning
     inline float WrapAngle(const float angle)
     {
 
-        const float new_angle = std::fmodf(angle, M_PI * 2.0f);
+        const float new_angle = std::fmod(angle, M_PI * 2.0f);
         return new_angle < 0 ? new_angle + M_PI * 2.0f : new_angle;
     }
     inline float NormalizeAngle(const float angle)
@@ -89,13 +89,13 @@ namespace auto_parking_planning
         return value;
     }
 
-    float Gaussian(const float u, const float std, const float x)
+    inline float Gaussian(const float u, const float std, const float x)
     {
-        return (1.0f / std::sqrtf(2 * M_PI * std * std)) *
-               std::expf(-(x - u) * (x - u) / (2 * std * std));
+        return (1.0f / std::sqrt(2 * M_PI * std * std)) *
+               std::exp(-(x - u) * (x - u) / (2 * std * std));
     }
 
-    inline float Sigmoid(const float x) { return 1.0f / (1.0f + std::expf(-x)); }
+    inline float Sigmoid(const float x) { return 1.0f / (1.0f + std::exp(-x)); }
 
     inline std::pair<double, double> RFUToFLU(const double x, const double y)
     {
@@ -137,7 +137,7 @@ namespace auto_parking_planning
         }
     }
 
-    std::pair<float, float> Cartesian2Polar(float x, float y)
+    inline std::pair<float, float> Cartesian2Polar(float x, float y)
     {
         float r = std::sqrt(x * x + y * y);
         float theta = std::atan2(y, x);
@@ -0,0 +1,200 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 10:41:37
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 10:41:37
+ */
+#include "path_projector.h"
+#include "math_utils.h"
+#include <algorithm>
+#include <limits>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr size_t kBlockSize = 16;
+        /// 提示两侧初始搜索的线段数, 最近线段落在窗口边缘时向该侧扩展, 总数超过上限即全局搜索
+        constexpr size_t kHintWindow = 4;
+        constexpr size_t kMaxLocalSegments = 256;
+    }
+
+    float PathProjector::Block::DistanceSquareTo(const float x, const float y) const
+    {
+        const float dx = std::max(0.0f, std::max(minX - x, x - maxX));
+        const float dy = std::max(0.0f, std::max(minY - y, y - maxY));
+        return dx * dx + dy * dy;
+    }
+
+    void PathProjector::Build(const XvizVec2View &points)
+    {
+        m_segments.clear();
+        m_s.clear();
+        m_blocks.clear();
+
+        size_t prev = 0;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            if (points[i].DistanceSquareTo(points[prev]) <= kMathEpsilon)
+            {
+                continue;
+            }
+            m_segments.emplace_back(points[prev], points[i]);
+            prev = i;
+        }
+        if (m_segments.empty())
+        {
+            return;
+        }
+
+        m_s.resize(m_segments.size() + 1);
+        m_s[0] = 0.0f;
+        for (size_t i = 0; i < m_segments.size(); ++i)
+        {
+            m_s[i + 1] = m_s[i] + m_segments[i].Length();
+        }
+
+        for (size_t begin = 0; begin < m_segments.size(); begin += kBlockSize)
+        {
+            const size_t end = std::min(m_segments.size(), begin + kBlockSize);
+            Block block;
+            block.minX = block.maxX = m_segments[begin].Start().x();
+            block.minY = block.maxY = m_segments[begin].Start().y();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Vec2f &p = m_segments[i].End();
+                block.minX = std::min(block.minX, p.x());
+                block.maxX = std::max(block.maxX, p.x());
+                block.minY = std::min(block.minY, p.y());
+                block.maxY = std::max(block.maxY, p.y());
+            }
+            m_blocks.push_back(block);
+        }
+    }
+
+    size_t PathProjector::NearestGlobal(const Vec2f &point, float *best_dist_sqr) const
+    {
+        // 按包围盒距离由近到远访问线段块, 盒距离不小于当前最优时停止
+        std::vector<std::pair<float, size_t>> order;
+        order.reserve(m_blocks.size());
+        for (size_t b = 0; b < m_blocks.size(); ++b)
+        {
+            order.emplace_back(m_blocks[b].DistanceSquareTo(point.x(), point.y()), b);
+        }
+        std::sort(order.begin(), order.end());
+
+        float best = std::numeric_limits<float>::max();
+        size_t best_segment = 0;
+        for (const auto &item : order)
+        {
+            if (item.first >= best)
+            {
+                break;
+            }
+            const size_t begin = item.second * kBlockSize;
+            const size_t end = std::min(m_segments.size(), begin + kBlockSize);
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float d = m_segments[i].DistanceSquareTo(point);
+                if (d < best)
+                {
+                    best = d;
+                    best_segment = i;
+                }
+            }
+        }
+        *best_dist_sqr = best;
+        return best_segment;
+    }
+
+    bool PathProjector::Project(const float x, const float y, const float yaw, const size_t hint,
+                                PathProjection *out) const
+    {
+        if (m_segments.empty())
+        {
+            return false;
+        }
+        if (hint >= m_segments.size())
+        {
+            return Project(x, y, yaw, out);
+        }
+
+        const Vec2f point(x, y);
+        size_t first = hint > kHintWindow ? hint - kHintWindow : 0;
+        size_t last = std::min(m_segments.size() - 1, hint + kHintWindow);
+        float best = std::numeric_limits<float>::max();
+        size_t best_segment = hint;
+        const auto scan = [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i <= end; ++i)
+            {
+                const float d = m_segments[i].DistanceSquareTo(point);
+                if (d < best)
+                {
+                    best = d;
+                    best_segment = i;
+                }
+            }
+        };
+        scan(first, last);
+        // 最近线段落在窗口边缘且该方向还有线段, 说明车辆可能已移出窗口, 向该侧加倍扩展
+        size_t step = kHintWindow;
+        while (last - first < kMaxLocalSegments)
+        {
+            if (best_segment == last && last + 1 < m_segments.size())
+            {
+                const size_t end = std::min(m_segments.size() - 1, last + step);
+                scan(last + 1, end);
+                last = end;
+            }
+            else if (best_segment == first && first > 0)
+            {
+                const size_t begin = first > step ? first - step : 0;
+                scan(begin, first - 1);
+                first = begin;
+            }
+            else
+            {
+                Fill(point, yaw, best_segment, out);
+                return true;
+            }
+            step *= 2;
+        }
+        return Project(x, y, yaw, out);
+    }
+
+    bool PathProjector::Project(const float x, const float y, const float yaw, PathProjection *out) const
+    {
+        if (m_segments.empty())
+        {
+            return false;
+        }
+        const Vec2f point(x, y);
+        float best;
+        Fill(point, yaw, NearestGlobal(point, &best), out);
+        return true;
+    }
+
+    void PathProjector::Fill(const Vec2f &point, const float yaw, const size_t segment, PathProjection *out) const
+    {
+        const LineSegment2f &seg = m_segments[segment];
+        seg.DistanceSquareTo(point, &out->point);
+        const float proj = std::min(std::max(seg.ProjectOntoUnit(point), 0.0f), seg.Length());
+        out->s = m_s[segment] + proj;
+        out->lateral = seg.ProductOntoUnit(point);
+        out->headingError = NormalizeAngle(yaw - seg.Heading());
+        out->segment = segment;
+    }
+
+    Vec2f PathProjector::PointAt(const float s) const
+    {
+        if (m_segments.empty())
+        {
+            return Vec2f();
+        }
+        const size_t upper = std::upper_bound(m_s.begin(), m_s.end(), s) - m_s.begin();
+        const size_t i = std::min(m_segments.size() - 1, upper > 0 ? upper - 1 : 0);
+        const float t = std::min(std::max(s - m_s[i], 0.0f), m_segments[i].Length());
+        return m_segments[i].Start() + m_segments[i].UnitDirection() * t;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,88 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 10:08:51
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 10:08:51
+ */
+
+#ifndef __PATH_PROJECTOR_H__
+#define __PATH_PROJECTOR_H__
+
+#include "segment2.h"
+#include "xviz_convert.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 点在路径上的投影
+    struct PathProjection
+    {
+        /// 投影点处的累计弧长
+        float s = 0.0f;
+        /// 横向偏差, 位于路径左侧为正
+        float lateral = 0.0f;
+        /// 航向减去路径切向, 归一化到 [-pi, pi)
+        float headingError = 0.0f;
+        /// 投影所在线段, 作为下一次查询的提示
+        size_t segment = 0;
+        Vec2f point;
+    };
+
+    /// @brief 预处理过的路径, 用于跟踪控制每个周期的"车在路径何处"查询.
+    /// 缓存各线段与累计弧长; 带提示的查询只在提示附近的窗口内搜索, 最近线段落在窗口边缘时
+    /// 向该侧加倍扩展, 扩展到上限或提示无效时退回按线段块包围盒剪枝的全局搜索
+    class PathProjector
+    {
+    public:
+        PathProjector() = default;
+
+        explicit PathProjector(const xviz::Path2f &path) { Build(XvizVec2View(path.points)); }
+
+        explicit PathProjector(const XvizVec2View &points) { Build(points); }
+
+        /// @brief 相邻重复点会被合并, 少于两个不同点时路径为空
+        void Build(const XvizVec2View &points);
+
+        /// @brief 以上一周期结果的 segment 为提示投影, 每周期摊还 O(1)
+        bool Project(const float x, const float y, const float yaw, const size_t hint, PathProjection *out) const;
+
+        /// @brief 无提示的全局投影
+        bool Project(const float x, const float y, const float yaw, PathProjection *out) const;
+
+        bool Empty() const { return m_segments.empty(); }
+
+        size_t SegmentCount() const { return m_segments.size(); }
+
+        float Length() const { return m_s.empty() ? 0.0f : m_s.back(); }
+
+        /// @brief 累计弧长 s 处的路径点
+        Vec2f PointAt(const float s) const;
+
+    private:
+        struct Block
+        {
+            float minX;
+            float minY;
+            float maxX;
+            float maxY;
+
+            float DistanceSquareTo(const float x, const float y) const;
+        };
+
+        size_t NearestGlobal(const Vec2f &point, float *best_dist_sqr) const;
+
+        void Fill(const Vec2f &point, const float yaw, const size_t segment, PathProjection *out) const;
+
+    private:
+        std::vector<LineSegment2f> m_segments;
+        /// 第 i 条线段起点的累计弧长, 共 SegmentCount() + 1 项
+        std::vector<float> m_s;
+        /// 每 kBlockSize 条连续线段的包围盒
+        std::vector<Block> m_blocks;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PATH_PROJECTOR_H__ */
@@ -0,0 +1,177 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-28 20:37:15
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-28 20:37:15
+ */
+#include "polyline_simplifier.h"
+#include "line_segment2f.h"
+
+namespace auto_parking_planning
+{
+    void PolylineSimplifier::SimplifyPolyline(const XvizVec2View &points, std::vector<xviz::Vec2f> *out)
+    {
+        out->clear();
+        AppendPolyline(points, out);
+    }
+
+    void PolylineSimplifier::SimplifyPolygon(const XvizVec2View &vertices, std::vector<xviz::Vec2f> *out)
+    {
+        out->clear();
+        AppendPolygon(vertices, out);
+    }
+
+    xviz::Path2f PolylineSimplifier::Simplify(const xviz::Path2f &path)
+    {
+        xviz::Path2f simplified;
+        simplified.header = path.header;
+        AppendPolyline(XvizVec2View(path.points.data(), path.points.size()), &simplified.points);
+        return simplified;
+    }
+
+    xviz::Polygon2f PolylineSimplifier::Simplify(const xviz::Polygon2f &polygon)
+    {
+        xviz::Polygon2f simplified;
+        simplified.header = polygon.header;
+        AppendPolygon(XvizVec2View(polygon.points.data(), polygon.points.size()), &simplified.points);
+        return simplified;
+    }
+
+    xviz::Polygons2f PolylineSimplifier::Simplify(const xviz::Polygons2f &polygons)
+    {
+        xviz::Polygons2f simplified;
+        simplified.header = polygons.header;
+        simplified.polygons.reserve(polygons.polygons.size());
+        for (const xviz::Polygon2f &polygon : polygons.polygons)
+        {
+            simplified.polygons.push_back(Simplify(polygon));
+        }
+        return simplified;
+    }
+
+    void PolylineSimplifier::SimplifyPolygons(const Span<uint32_t> &offsets, const Span<xviz::Vec2f> &vertices,
+                                              std::vector<uint32_t> *out_offsets,
+                                              std::vector<xviz::Vec2f> *out_vertices)
+    {
+        out_offsets->assign(1, 0);
+        out_vertices->clear();
+        for (size_t p = 0; p + 1 < offsets.size(); ++p)
+        {
+            const uint32_t begin = offsets[p];
+            const uint32_t end = offsets[p + 1];
+            AppendPolygon(XvizVec2View(vertices.data() + begin, end - begin), out_vertices);
+            out_offsets->push_back(static_cast<uint32_t>(out_vertices->size()));
+        }
+    }
+
+    void PolylineSimplifier::AppendPolyline(const XvizVec2View &points, std::vector<xviz::Vec2f> *out)
+    {
+        const size_t n = points.size();
+        if (m_tolerance <= 0.0f || n <= 2)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out->push_back(ToXviz(points[i]));
+            }
+            return;
+        }
+        m_keep.assign(n, 0);
+        m_keep[0] = 1;
+        m_keep[n - 1] = 1;
+        MarkKept(points, n, 0, n - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (m_keep[i])
+            {
+                out->push_back(ToXviz(points[i]));
+            }
+        }
+    }
+
+    void PolylineSimplifier::AppendPolygon(const XvizVec2View &vertices, std::vector<xviz::Vec2f> *out)
+    {
+        size_t n = vertices.size();
+        if (n > 1 && vertices[0] == vertices[n - 1])
+        {
+            --n;
+        }
+        if (m_tolerance <= 0.0f || n <= 3)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out->push_back(ToXviz(vertices[i]));
+            }
+            return;
+        }
+
+        // 以首顶点和离它最远的顶点为锚点, 把环分成两条折线分别化简
+        size_t far = 0;
+        float far_dist = 0.0f;
+        for (size_t i = 1; i < n; ++i)
+        {
+            const float dist = vertices[0].DistanceSquareTo(vertices[i]);
+            if (dist > far_dist)
+            {
+                far_dist = dist;
+                far = i;
+            }
+        }
+        m_keep.assign(n, 0);
+        m_keep[0] = 1;
+        m_keep[far] = 1;
+        MarkKept(vertices, n, 0, far);
+        MarkKept(vertices, n, far, n);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            kept += m_keep[i];
+        }
+        // 所有顶点都在容差带内的细长多边形, 化简会使其退化
+        const bool degenerate = kept < 3;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (degenerate || m_keep[i])
+            {
+                out->push_back(ToXviz(vertices[i]));
+            }
+        }
+    }
+
+    void PolylineSimplifier::MarkKept(const XvizVec2View &points, const size_t count, const size_t first,
+                                      const size_t last)
+    {
+        m_stack.clear();
+        m_stack.emplace_back(first, last);
+        while (!m_stack.empty())
+        {
+            const size_t begin = m_stack.back().first;
+            const size_t end = m_stack.back().second;
+            m_stack.pop_back();
+            if (end <= begin + 1)
+            {
+                continue;
+            }
+            const LineSegment2f chord(points[begin % count], points[end % count]);
+            size_t split = 0;
+            float split_dist = m_tolerance;
+            for (size_t i = begin + 1; i < end; ++i)
+            {
+                const float dist = chord.DistanceTo(points[i % count]);
+                if (dist > split_dist)
+                {
+                    split_dist = dist;
+                    split = i;
+                }
+            }
+            if (split == 0)
+            {
+                continue;
+            }
+            m_keep[split % count] = 1;
+            m_stack.emplace_back(begin, split);
+            m_stack.emplace_back(split, end);
+        }
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,66 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-28 20:12:46
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-28 20:12:46
+ */
+
+#ifndef __POLYLINE_SIMPLIFIER_H__
+#define __POLYLINE_SIMPLIFIER_H__
+
+#include "common/span.h"
+#include "data_types.h"
+#include "xviz_convert.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief Douglas-Peucker 折线与多边形化简. 被删去的点到保留下来的对应线段的距离都不超过 tolerance,
+    /// 距离按线段(而非直线)计算, 倒车路径的换挡折返点不会被当作共线点删去.
+    /// 用显式栈代替递归, 工作区在多次调用间复用, 单个对象不可并发使用
+    class PolylineSimplifier
+    {
+    public:
+        /// @param tolerance 单位米, 不大于 0 时原样输出
+        explicit PolylineSimplifier(const float tolerance = 0.05f) : m_tolerance(tolerance) {}
+
+        float Tolerance() const { return m_tolerance; }
+
+        /// @brief 开放折线, 保留首尾点
+        void SimplifyPolyline(const XvizVec2View &points, std::vector<xviz::Vec2f> *out);
+
+        /// @brief 闭合多边形, 首尾重复的闭合点会被去掉; 化简后不足 3 个顶点时原样输出
+        void SimplifyPolygon(const XvizVec2View &vertices, std::vector<xviz::Vec2f> *out);
+
+        xviz::Path2f Simplify(const xviz::Path2f &path);
+
+        xviz::Polygon2f Simplify(const xviz::Polygon2f &polygon);
+
+        /// @brief 批量化简一组多边形, 消息头保持不变
+        xviz::Polygons2f Simplify(const xviz::Polygons2f &polygons);
+
+        /// @brief 批量化简按偏移数组连续存放的多边形(同 ObstacleView 的布局),
+        /// 第 i 个多边形的顶点为 vertices[offsets[i], offsets[i + 1])
+        void SimplifyPolygons(const Span<uint32_t> &offsets, const Span<xviz::Vec2f> &vertices,
+                              std::vector<uint32_t> *out_offsets, std::vector<xviz::Vec2f> *out_vertices);
+
+    private:
+        void AppendPolyline(const XvizVec2View &points, std::vector<xviz::Vec2f> *out);
+
+        void AppendPolygon(const XvizVec2View &vertices, std::vector<xviz::Vec2f> *out);
+
+        /// @brief 标记 points 中 (first, last) 之间需保留的点, 下标对 count 取模以支持闭合多边形
+        void MarkKept(const XvizVec2View &points, const size_t count, const size_t first, const size_t last);
+
+    private:
+        float m_tolerance;
+        std::vector<std::pair<size_t, size_t>> m_stack;
+        std::vector<uint8_t> m_keep;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __POLYLINE_SIMPLIFIER_H__ */
@@ -0,0 +1,259 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 19:40:03
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 19:40:03
+ */
+#include "prepared_polygon.h"
+#include <algorithm>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr int kBatchLanes = 8;
+
+        float Cross(const float ax, const float ay, const float bx, const float by) { return ax * by - ay * bx; }
+    }
+
+    void PreparedPolygon::Build(const XvizVec2View &vertices)
+    {
+        m_xs.clear();
+        m_ys.clear();
+        m_slabYs.clear();
+        m_slabOffsets.clear();
+        m_slabEdges.clear();
+        m_convex = false;
+        m_box = Box();
+
+        size_t n = vertices.size();
+        if (n > 1 && vertices[0] == vertices[n - 1])
+        {
+            --n;
+        }
+        if (n < 3)
+        {
+            return;
+        }
+        m_xs.resize(n);
+        m_ys.resize(n);
+        float area = 0.0f;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Vec2f p = vertices[i];
+            const Vec2f q = vertices[(i + 1) % n];
+            m_xs[i] = p.x();
+            m_ys[i] = p.y();
+            area += p.CrossProd(q);
+        }
+        if (area < 0.0f)
+        {
+            std::reverse(m_xs.begin(), m_xs.end());
+            std::reverse(m_ys.begin(), m_ys.end());
+        }
+
+        m_box.minX = *std::min_element(m_xs.begin(), m_xs.end());
+        m_box.maxX = *std::max_element(m_xs.begin(), m_xs.end());
+        m_box.minY = *std::min_element(m_ys.begin(), m_ys.end());
+        m_box.maxY = *std::max_element(m_ys.begin(), m_ys.end());
+
+        // 逆时针下每个顶点都不右转即为凸
+        m_convex = area != 0.0f;
+        for (size_t i = 0; i < n && m_convex; ++i)
+        {
+            const size_t j = (i + 1) % n;
+            const size_t k = (i + 2) % n;
+            m_convex = Cross(m_xs[j] - m_xs[i], m_ys[j] - m_ys[i], m_xs[k] - m_xs[j], m_ys[k] - m_ys[j]) >= 0.0f;
+        }
+        if (!m_convex)
+        {
+            BuildSlabs();
+        }
+    }
+
+    void PreparedPolygon::BuildSlabs()
+    {
+        const size_t n = m_xs.size();
+        m_slabYs = m_ys;
+        std::sort(m_slabYs.begin(), m_slabYs.end());
+        m_slabYs.erase(std::unique(m_slabYs.begin(), m_slabYs.end()), m_slabYs.end());
+        const size_t slabs = m_slabYs.size() - 1;
+
+        // 先计数再填充, 得到按条带连续存放的边表
+        std::vector<std::pair<size_t, size_t>> spans(n);
+        m_slabOffsets.assign(slabs + 1, 0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t j = (i + 1) % n;
+            const float lo = std::min(m_ys[i], m_ys[j]);
+            const float hi = std::max(m_ys[i], m_ys[j]);
+            const size_t first = std::lower_bound(m_slabYs.begin(), m_slabYs.end(), lo) - m_slabYs.begin();
+            const size_t last = std::lower_bound(m_slabYs.begin(), m_slabYs.end(), hi) - m_slabYs.begin();
+            spans[i] = std::make_pair(first, last);
+            for (size_t s = first; s < last; ++s)
+            {
+                ++m_slabOffsets[s + 1];
+            }
+        }
+        for (size_t s = 0; s < slabs; ++s)
+        {
+            m_slabOffsets[s + 1] += m_slabOffsets[s];
+        }
+        m_slabEdges.resize(m_slabOffsets[slabs]);
+        std::vector<uint32_t> cursor(m_slabOffsets.begin(), m_slabOffsets.end() - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t j = (i + 1) % n;
+            if (spans[i].first == spans[i].second)
+            {
+                continue;
+            }
+            Edge edge;
+            edge.x0 = m_xs[i];
+            edge.y0 = m_ys[i];
+            edge.dxdy = (m_xs[j] - m_xs[i]) / (m_ys[j] - m_ys[i]);
+            for (size_t s = spans[i].first; s < spans[i].second; ++s)
+            {
+                m_slabEdges[cursor[s]++] = edge;
+            }
+        }
+        for (size_t s = 0; s < slabs; ++s)
+        {
+            const float mid = 0.5f * (m_slabYs[s] + m_slabYs[s + 1]);
+            std::sort(m_slabEdges.begin() + m_slabOffsets[s], m_slabEdges.begin() + m_slabOffsets[s + 1],
+                      [mid](const Edge &a, const Edge &b) { return a.XAt(mid) < b.XAt(mid); });
+        }
+    }
+
+    bool PreparedPolygon::ConvexContains(const float x, const float y) const
+    {
+        const size_t n = m_xs.size();
+        const float px = x - m_xs[0];
+        const float py = y - m_ys[0];
+        if (Cross(m_xs[1] - m_xs[0], m_ys[1] - m_ys[0], px, py) < 0.0f ||
+            Cross(m_xs[n - 1] - m_xs[0], m_ys[n - 1] - m_ys[0], px, py) > 0.0f)
+        {
+            return false;
+        }
+        // 定位点所在的扇区 (v0, v[lo], v[lo + 1])
+        size_t lo = 1;
+        size_t hi = n - 1;
+        while (hi - lo > 1)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (Cross(m_xs[mid] - m_xs[0], m_ys[mid] - m_ys[0], px, py) >= 0.0f)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return Cross(m_xs[hi] - m_xs[lo], m_ys[hi] - m_ys[lo], x - m_xs[lo], y - m_ys[lo]) >= 0.0f;
+    }
+
+    bool PreparedPolygon::SlabContains(const float x, const float y) const
+    {
+        if (y >= m_slabYs.back())
+        {
+            return false;
+        }
+        const size_t slab = std::upper_bound(m_slabYs.begin(), m_slabYs.end(), y) - m_slabYs.begin() - 1;
+        const Edge *first = m_slabEdges.data() + m_slabOffsets[slab];
+        const Edge *last = m_slabEdges.data() + m_slabOffsets[slab + 1];
+        const Edge *split = std::partition_point(first, last, [x, y](const Edge &e) { return e.XAt(y) < x; });
+        return ((split - first) & 1) != 0;
+    }
+
+    bool PreparedPolygon::Contains(const float x, const float y) const
+    {
+        if (Empty() || !InBox(x, y))
+        {
+            return false;
+        }
+        return m_convex ? ConvexContains(x, y) : SlabContains(x, y);
+    }
+
+    void PreparedPolygon::Contains(const float *xs, const float *ys, const size_t count, uint8_t *inside) const
+    {
+        if (Empty())
+        {
+            std::fill(inside, inside + count, 0);
+            return;
+        }
+        size_t i = 0;
+        if (m_convex)
+        {
+            // 凸多边形的边数通常很少(车位为 4), 对一组点逐边做半平面测试, 无分支, 内层循环可向量化
+            const size_t n = m_xs.size();
+            for (; i + kBatchLanes <= count; i += kBatchLanes)
+            {
+                const float *px = xs + i;
+                const float *py = ys + i;
+                int32_t in[kBatchLanes];
+                for (int k = 0; k < kBatchLanes; ++k)
+                {
+                    in[k] = (px[k] >= m_box.minX) & (px[k] <= m_box.maxX) & (py[k] >= m_box.minY) & (py[k] <= m_box.maxY);
+                }
+                for (size_t e = 0; e < n; ++e)
+                {
+                    const size_t f = e + 1 == n ? 0 : e + 1;
+                    const float ex = m_xs[f] - m_xs[e];
+                    const float ey = m_ys[f] - m_ys[e];
+                    const float x0 = m_xs[e];
+                    const float y0 = m_ys[e];
+                    for (int k = 0; k < kBatchLanes; ++k)
+                    {
+                        in[k] &= ex * (py[k] - y0) - ey * (px[k] - x0) >= 0.0f;
+                    }
+                }
+                for (int k = 0; k < kBatchLanes; ++k)
+                {
+                    inside[i + k] = static_cast<uint8_t>(in[k]);
+                }
+            }
+        }
+        for (; i < count; ++i)
+        {
+            inside[i] = Contains(xs[i], ys[i]) ? 1 : 0;
+        }
+    }
+
+    size_t PreparedPolygon::CountInside(const float *xs, const float *ys, const size_t count) const
+    {
+        uint8_t inside[256];
+        size_t total = 0;
+        for (size_t i = 0; i < count; i += sizeof(inside))
+        {
+            const size_t n = std::min(sizeof(inside), count - i);
+            Contains(xs + i, ys + i, n, inside);
+            for (size_t k = 0; k < n; ++k)
+            {
+                total += inside[k];
+            }
+        }
+        return total;
+    }
+
+    size_t PreparedPolygon::CountInside(const XvizCloudView &cloud) const
+    {
+        // AoS 点云分块转为 SoA 后批量查询
+        float xs[256];
+        float ys[256];
+        size_t total = 0;
+        for (size_t i = 0; i < cloud.size(); i += 256)
+        {
+            const size_t n = std::min<size_t>(256, cloud.size() - i);
+            for (size_t k = 0; k < n; ++k)
+            {
+                const Vec2f p = cloud[i + k];
+                xs[k] = p.x();
+                ys[k] = p.y();
+            }
+            total += CountInside(xs, ys, n);
+        }
+        return total;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,101 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 19:14:26
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 19:14:26
+ */
+
+#ifndef __PREPARED_POLYGON_H__
+#define __PREPARED_POLYGON_H__
+
+#include "vec2.h"
+#include "xviz_convert.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 为点包含查询预处理过的简单多边形, 由 xviz::Polygon2f 构建一次后反复查询.
+    /// 凸多边形以首顶点为扇心二分定位扇区; 非凸多边形按顶点 y 值切分为水平条带,
+    /// 每条带内的边互不相交且按 x 排序, 二分统计左侧穿越数. 两者均为 O(log n).
+    /// 边界上的点可能判为任一侧
+    class PreparedPolygon
+    {
+    public:
+        struct Box
+        {
+            float minX = 0.0f;
+            float minY = 0.0f;
+            float maxX = 0.0f;
+            float maxY = 0.0f;
+        };
+
+        PreparedPolygon() = default;
+
+        explicit PreparedPolygon(const xviz::Polygon2f &polygon) { Build(XvizVec2View(polygon.points)); }
+
+        explicit PreparedPolygon(const XvizVec2View &vertices) { Build(vertices); }
+
+        /// @brief 首尾重复的闭合点会被去掉, 少于 3 个顶点时不包含任何点
+        void Build(const XvizVec2View &vertices);
+
+        bool Contains(const float x, const float y) const;
+
+        bool Contains(const Vec2f &point) const { return Contains(point.x(), point.y()); }
+
+        /// @brief SoA 批量查询, inside[i] 为 1 表示 (xs[i], ys[i]) 在多边形内
+        void Contains(const float *xs, const float *ys, const size_t count, uint8_t *inside) const;
+
+        /// @brief 落在多边形内的点数, 用于车位占用等统计
+        size_t CountInside(const float *xs, const float *ys, const size_t count) const;
+
+        size_t CountInside(const XvizCloudView &cloud) const;
+
+        bool IsConvex() const { return m_convex; }
+
+        bool Empty() const { return m_xs.size() < 3; }
+
+        size_t Size() const { return m_xs.size(); }
+
+        const Box &Bounds() const { return m_box; }
+
+    private:
+        /// 非水平边, 以 y 参数化: x = x0 + (y - y0) * dxdy
+        struct Edge
+        {
+            float x0;
+            float y0;
+            float dxdy;
+
+            float XAt(const float y) const { return x0 + (y - y0) * dxdy; }
+        };
+
+        bool InBox(const float x, const float y) const
+        {
+            return x >= m_box.minX && x <= m_box.maxX && y >= m_box.minY && y <= m_box.maxY;
+        }
+
+        bool ConvexContains(const float x, const float y) const;
+
+        bool SlabContains(const float x, const float y) const;
+
+        void BuildSlabs();
+
+    private:
+        /// 逆时针顶点
+        std::vector<float> m_xs;
+        std::vector<float> m_ys;
+        Box m_box;
+        bool m_convex = false;
+
+        /// 条带边界(升序去重的顶点 y), 第 i 条带为 [m_slabYs[i], m_slabYs[i + 1])
+        std::vector<float> m_slabYs;
+        /// 第 i 条带的边为 m_slabEdges[m_slabOffsets[i], m_slabOffsets[i + 1])
+        std::vector<uint32_t> m_slabOffsets;
+        std::vector<Edge> m_slabEdges;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PREPARED_POLYGON_H__ */
@@ -0,0 +1,187 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-19 20:58:27
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-19 20:58:27
+ */
+
+#ifndef __SEGMENT2_H__
+#define __SEGMENT2_H__
+
+#include "vec2.h"
+#include <utility>
+
+namespace auto_parking_planning
+{
+    template <typename T>
+    inline bool IsWithin(const T val, T bound1, T bound2)
+    {
+        if (bound1 > bound2)
+        {
+            std::swap(bound1, bound2);
+        }
+        return val >= bound1 - kMathEpsilon && val <= bound2 + kMathEpsilon;
+    }
+
+    /// @brief 线段, T 可为 float、double 或 Pack<float, N>.
+    /// 距离类接口不含分支(投影量截断到 [0, length]), 标量与数值包共用同一实现;
+    /// 求交类接口只对标量类型有意义
+    template <typename T>
+    class Segment2
+    {
+    public:
+        typedef Vec2<T> Point;
+        typedef typename simd::Traits<T>::Mask Mask;
+
+        Segment2() : m_unitDirection(T(1), T(0)), m_heading(T(0)), m_length(T(0)) {}
+
+        Segment2(const Point &start, const Point &end) : m_start(start), m_end(end)
+        {
+            const Point diff = m_end - m_start;
+            m_length = diff.Length();
+            const Mask degenerate = m_length <= Point::Epsilon();
+            const T inv_length = T(1) / simd::Max(m_length, Point::Epsilon());
+            m_unitDirection = Point(simd::Select(degenerate, T(0), diff.x() * inv_length),
+                                    simd::Select(degenerate, T(0), diff.y() * inv_length));
+            m_heading = m_unitDirection.Angle();
+        }
+
+        const Point &Start() const { return m_start; }
+
+        const Point &End() const { return m_end; }
+
+        const Point &UnitDirection() const { return m_unitDirection; }
+
+        Point Center() const { return (m_start + m_end) * T(0.5f); }
+
+        /// @brief 终点绕起点旋转 angle 后的位置
+        Point Rotate(const T &angle) const { return m_start + (m_end - m_start).Rotate(angle); }
+
+        const T &Heading() const { return m_heading; }
+
+        const T &CosHeading() const { return m_unitDirection.x(); }
+
+        const T &SinHeading() const { return m_unitDirection.y(); }
+
+        const T &Length() const { return m_length; }
+
+        T LengthSqr() const { return m_length * m_length; }
+
+        T DistanceTo(const Point &point) const
+        {
+            Point nearest;
+            return simd::Sqrt(DistanceSquareTo(point, &nearest));
+        }
+
+        T DistanceTo(const Point &point, Point *const nearest_pt) const
+        {
+            return simd::Sqrt(DistanceSquareTo(point, nearest_pt));
+        }
+
+        T DistanceSquareTo(const Point &point) const
+        {
+            Point nearest;
+            return DistanceSquareTo(point, &nearest);
+        }
+
+        T DistanceSquareTo(const Point &point, Point *const nearest_pt) const
+        {
+            // 退化线段的单位方向为零向量, 投影为 0, 最近点即起点
+            const T proj = simd::Clamp(ProjectOntoUnit(point), T(0), m_length);
+            *nearest_pt = m_start + m_unitDirection * proj;
+            return point.DistanceSquareTo(*nearest_pt);
+        }
+
+        /// @brief 点是否在线段上
+        bool IsPointIn(const Point &point) const
+        {
+            if (m_length <= Point::Epsilon())
+            {
+                return simd::Abs(point.x() - m_start.x()) <= Point::Epsilon() &&
+                       simd::Abs(point.y() - m_start.y()) <= Point::Epsilon();
+            }
+            const T prod = (point - m_start).CrossProd(m_end - m_start);
+            if (simd::Abs(prod) > Point::Epsilon())
+            {
+                return false;
+            }
+            return IsWithin(point.x(), m_start.x(), m_end.x()) && IsWithin(point.y(), m_start.y(), m_end.y());
+        }
+
+        /// @brief 两线段是否相交(含端点接触)
+        bool HasIntersect(const Segment2 &other_segment) const
+        {
+            Point point;
+            return GetIntersect(other_segment, &point);
+        }
+
+        bool GetIntersect(const Segment2 &other_segment, Point *const point) const
+        {
+            const Point &a = m_start;
+            const Point &b = m_end;
+            const Point &c = other_segment.Start();
+            const Point &d = other_segment.End();
+            const T cc1 = (b - a).CrossProd(c - a);
+            const T cc2 = (b - a).CrossProd(d - a);
+            const T cc3 = (d - c).CrossProd(a - c);
+            const T cc4 = (d - c).CrossProd(b - c);
+            const T eps = Point::Epsilon();
+            // 共线或端点落在另一线段上
+            if (simd::Abs(cc1) <= eps && IsWithin(c.x(), a.x(), b.x()) && IsWithin(c.y(), a.y(), b.y()))
+            {
+                *point = c;
+                return true;
+            }
+            if (simd::Abs(cc2) <= eps && IsWithin(d.x(), a.x(), b.x()) && IsWithin(d.y(), a.y(), b.y()))
+            {
+                *point = d;
+                return true;
+            }
+            if (simd::Abs(cc3) <= eps && IsWithin(a.x(), c.x(), d.x()) && IsWithin(a.y(), c.y(), d.y()))
+            {
+                *point = a;
+                return true;
+            }
+            if (simd::Abs(cc4) <= eps && IsWithin(b.x(), c.x(), d.x()) && IsWithin(b.y(), c.y(), d.y()))
+            {
+                *point = b;
+                return true;
+            }
+            if (cc1 * cc2 >= 0 || cc3 * cc4 >= 0)
+            {
+                return false;
+            }
+            const T ratio = cc4 / (cc4 - cc3);
+            *point = a + (b - a) * ratio;
+            return true;
+        }
+
+        /// @brief 点在线段方向上的投影长度(以起点为原点)
+        T ProjectOntoUnit(const Point &point) const { return m_unitDirection.InnerProd(point - m_start); }
+
+        /// @brief 线段方向与 (point - start) 的叉积, 点在左侧为正
+        T ProductOntoUnit(const Point &point) const { return m_unitDirection.CrossProd(point - m_start); }
+
+        /// @brief 点到所在直线的垂足, 返回点到直线的距离
+        T GetPerpendicularFoot(const Point &point, Point *const foot_point) const
+        {
+            *foot_point = m_start + m_unitDirection * ProjectOntoUnit(point);
+            return simd::Abs(ProductOntoUnit(point));
+        }
+
+    private:
+        Point m_start;
+        Point m_end;
+        Point m_unitDirection;
+        T m_heading;
+        T m_length;
+    };
+
+    typedef Segment2<float> LineSegment2f;
+    typedef Segment2<double> LineSegment2d;
+    typedef Segment2<PackF4> LineSegment2x4;
+    typedef Segment2<PackF8> LineSegment2x8;
+
+} // namespace auto_parking_planning
+
+#endif /* __SEGMENT2_H__ */
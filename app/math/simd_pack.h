@@ -0,0 +1,237 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-19 19:36:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-19 19:36:12
+ */
+
+#ifndef __SIMD_PACK_H__
+#define __SIMD_PACK_H__
+
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    /// @brief 逐通道比较结果
+    template <int N>
+    struct PackMask
+    {
+        bool lanes[N];
+
+        friend PackMask operator&(const PackMask &a, const PackMask &b)
+        {
+            PackMask r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = a.lanes[i] && b.lanes[i];
+            return r;
+        }
+
+        friend PackMask operator|(const PackMask &a, const PackMask &b)
+        {
+            PackMask r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = a.lanes[i] || b.lanes[i];
+            return r;
+        }
+
+        friend PackMask operator!(const PackMask &a)
+        {
+            PackMask r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = !a.lanes[i];
+            return r;
+        }
+    };
+
+    /// @brief N 通道数值包. 以定长数组实现, 逐通道循环交给编译器向量化,
+    /// 不依赖特定指令集. 标量可隐式广播, 因此几何模板可直接以 Pack 实例化
+    template <typename T, int N>
+    struct alignas(sizeof(T) * N) Pack
+    {
+        typedef T Scalar;
+        typedef PackMask<N> Mask;
+        static constexpr int kLanes = N;
+
+        T lanes[N];
+
+        Pack() : lanes{} {}
+
+        Pack(const T value)
+        {
+            for (int i = 0; i < N; ++i)
+                lanes[i] = value;
+        }
+
+        static Pack Load(const T *data)
+        {
+            Pack r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = data[i];
+            return r;
+        }
+
+        void Store(T *data) const
+        {
+            for (int i = 0; i < N; ++i)
+                data[i] = lanes[i];
+        }
+
+        T &operator[](const int i) { return lanes[i]; }
+
+        const T &operator[](const int i) const { return lanes[i]; }
+
+#define APP_PACK_BINARY_OP(op)                                   \
+    friend Pack operator op(const Pack &a, const Pack &b)        \
+    {                                                            \
+        Pack r;                                                  \
+        for (int i = 0; i < N; ++i)                              \
+            r.lanes[i] = a.lanes[i] op b.lanes[i];               \
+        return r;                                                \
+    }                                                            \
+    Pack &operator op##=(const Pack &b) { return *this = *this op b; }
+
+        APP_PACK_BINARY_OP(+)
+        APP_PACK_BINARY_OP(-)
+        APP_PACK_BINARY_OP(*)
+        APP_PACK_BINARY_OP(/)
+#undef APP_PACK_BINARY_OP
+
+#define APP_PACK_COMPARE_OP(op)                                  \
+    friend Mask operator op(const Pack &a, const Pack &b)        \
+    {                                                            \
+        Mask r;                                                  \
+        for (int i = 0; i < N; ++i)                              \
+            r.lanes[i] = a.lanes[i] op b.lanes[i];               \
+        return r;                                                \
+    }
+
+        APP_PACK_COMPARE_OP(<)
+        APP_PACK_COMPARE_OP(<=)
+        APP_PACK_COMPARE_OP(>)
+        APP_PACK_COMPARE_OP(>=)
+#undef APP_PACK_COMPARE_OP
+
+        friend Pack operator-(const Pack &a)
+        {
+            Pack r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = -a.lanes[i];
+            return r;
+        }
+    };
+
+    typedef Pack<float, 4> PackF4;
+    typedef Pack<float, 8> PackF8;
+
+    /// 标量与数值包共用的逐通道运算, 几何模板只通过这里访问数学函数
+    namespace simd
+    {
+        template <typename T>
+        struct Traits
+        {
+            typedef T Scalar;
+            typedef bool Mask;
+            static constexpr int kLanes = 1;
+        };
+
+        template <typename T, int N>
+        struct Traits<Pack<T, N>>
+        {
+            typedef T Scalar;
+            typedef PackMask<N> Mask;
+            static constexpr int kLanes = N;
+        };
+
+        inline bool Any(const bool m) { return m; }
+
+        inline bool All(const bool m) { return m; }
+
+        template <int N>
+        bool Any(const PackMask<N> &m)
+        {
+            bool r = false;
+            for (int i = 0; i < N; ++i)
+                r = r || m.lanes[i];
+            return r;
+        }
+
+        template <int N>
+        bool All(const PackMask<N> &m)
+        {
+            bool r = true;
+            for (int i = 0; i < N; ++i)
+                r = r && m.lanes[i];
+            return r;
+        }
+
+        template <typename T>
+        T Select(const bool m, const T &a, const T &b)
+        {
+            return m ? a : b;
+        }
+
+        template <typename T, int N>
+        Pack<T, N> Select(const PackMask<N> &m, const Pack<T, N> &a, const Pack<T, N> &b)
+        {
+            Pack<T, N> r;
+            for (int i = 0; i < N; ++i)
+                r.lanes[i] = m.lanes[i] ? a.lanes[i] : b.lanes[i];
+            return r;
+        }
+
+#define APP_SIMD_UNARY(name, expr)                          \
+    inline float name(const float x) { return expr; }       \
+    inline double name(const double x) { return expr; }     \
+    template <typename T, int N>                            \
+    Pack<T, N> name(const Pack<T, N> &p)                    \
+    {                                                       \
+        Pack<T, N> r;                                       \
+        for (int i = 0; i < N; ++i)                         \
+            r.lanes[i] = name(p.lanes[i]);                  \
+        return r;                                           \
+    }
+
+        APP_SIMD_UNARY(Sqrt, std::sqrt(x))
+        APP_SIMD_UNARY(Abs, std::fabs(x))
+        APP_SIMD_UNARY(Sin, std::sin(x))
+        APP_SIMD_UNARY(Cos, std::cos(x))
+#undef APP_SIMD_UNARY
+
+#define APP_SIMD_BINARY(name, expr)                                         \
+    inline float name(const float a, const float b) { return expr; }        \
+    inline double name(const double a, const double b) { return expr; }     \
+    template <typename T, int N>                                            \
+    Pack<T, N> name(const Pack<T, N> &pa, const Pack<T, N> &pb)             \
+    {                                                                       \
+        Pack<T, N> r;                                                       \
+        for (int i = 0; i < N; ++i)                                         \
+            r.lanes[i] = name(pa.lanes[i], pb.lanes[i]);                    \
+        return r;                                                           \
+    }
+
+        APP_SIMD_BINARY(Min, a < b ? a : b)
+        APP_SIMD_BINARY(Max, a < b ? b : a)
+        APP_SIMD_BINARY(Atan2, std::atan2(a, b))
+#undef APP_SIMD_BINARY
+
+        inline float Hypot(const float a, const float b) { return std::hypot(a, b); }
+
+        inline double Hypot(const double a, const double b) { return std::hypot(a, b); }
+
+        /// 数值包不做溢出保护, 换取可向量化
+        template <typename T, int N>
+        Pack<T, N> Hypot(const Pack<T, N> &a, const Pack<T, N> &b)
+        {
+            return Sqrt(a * a + b * b);
+        }
+
+        template <typename T>
+        T Clamp(const T &value, const T &lo, const T &hi)
+        {
+            return Min(Max(value, lo), hi);
+        }
+    }
+
+} // namespace auto_parking_planning
+
+#endif /* __SIMD_PACK_H__ */
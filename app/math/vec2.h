@@ -0,0 +1,140 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-19 20:12:48
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-19 20:12:48
+ */
+
+#ifndef __VEC2_H__
+#define __VEC2_H__
+
+#include "simd_pack.h"
+
+namespace auto_parking_planning
+{
+    constexpr float kMathEpsilon = 1e-10f;
+
+    /// @brief 二维向量, T 可为 float、double 或 Pack<float, N>.
+    /// 以 Pack 实例化时每个通道是一个独立向量, 比较类接口返回逐通道掩码
+    template <typename T>
+    class Vec2
+    {
+    public:
+        typedef T Scalar;
+        typedef typename simd::Traits<T>::Mask Mask;
+
+        constexpr Vec2(const T &x, const T &y) noexcept : m_x(x), m_y(y) {}
+
+        constexpr Vec2() noexcept : Vec2(T(0), T(0)) {}
+
+        static Vec2 CreateUnitVec2(const T &angle) { return Vec2(simd::Cos(angle), simd::Sin(angle)); }
+
+        /// @brief 同 CreateUnitVec2, 保留原 Vec2f 的接口名
+        static Vec2 CreateUnitVec2f(const T &angle) { return CreateUnitVec2(angle); }
+
+        static T Epsilon() { return T(static_cast<typename simd::Traits<T>::Scalar>(kMathEpsilon)); }
+
+        const T &x() const { return m_x; }
+
+        const T &y() const { return m_y; }
+
+        void SetX(const T &x) { m_x = x; }
+
+        void SetY(const T &y) { m_y = y; }
+
+        T Length() const { return simd::Hypot(m_x, m_y); }
+
+        T LengthSquare() const { return m_x * m_x + m_y * m_y; }
+
+        T Angle() const { return simd::Atan2(m_y, m_x); }
+
+        void Normalize()
+        {
+            const T l = Length();
+            const Mask valid = l > Epsilon();
+            m_x = simd::Select(valid, m_x / l, m_x);
+            m_y = simd::Select(valid, m_y / l, m_y);
+        }
+
+        T DistanceTo(const Vec2 &other) const { return simd::Hypot(m_x - other.m_x, m_y - other.m_y); }
+
+        T DistanceSquareTo(const Vec2 &other) const
+        {
+            const T dx = m_x - other.m_x;
+            const T dy = m_y - other.m_y;
+            return dx * dx + dy * dy;
+        }
+
+        T CrossProd(const Vec2 &other) const { return m_x * other.m_y - m_y * other.m_x; }
+
+        T InnerProd(const Vec2 &other) const { return m_x * other.m_x + m_y * other.m_y; }
+
+        Vec2 Rotate(const T &angle) const
+        {
+            const T c = simd::Cos(angle);
+            const T s = simd::Sin(angle);
+            return Vec2(m_x * c - m_y * s, m_x * s + m_y * c);
+        }
+
+        void SelfRotate(const T &angle) { *this = Rotate(angle); }
+
+        Vec2 operator+(const Vec2 &other) const { return Vec2(m_x + other.m_x, m_y + other.m_y); }
+
+        Vec2 operator-(const Vec2 &other) const { return Vec2(m_x - other.m_x, m_y - other.m_y); }
+
+        Vec2 operator*(const T &ratio) const { return Vec2(m_x * ratio, m_y * ratio); }
+
+        Vec2 operator/(const T &ratio) const { return Vec2(m_x / ratio, m_y / ratio); }
+
+        Vec2 &operator+=(const Vec2 &other)
+        {
+            m_x += other.m_x;
+            m_y += other.m_y;
+            return *this;
+        }
+
+        Vec2 &operator-=(const Vec2 &other)
+        {
+            m_x -= other.m_x;
+            m_y -= other.m_y;
+            return *this;
+        }
+
+        Vec2 &operator*=(const T &ratio)
+        {
+            m_x *= ratio;
+            m_y *= ratio;
+            return *this;
+        }
+
+        Vec2 &operator/=(const T &ratio)
+        {
+            m_x /= ratio;
+            m_y /= ratio;
+            return *this;
+        }
+
+        Mask operator==(const Vec2 &other) const
+        {
+            return (simd::Abs(m_x - other.m_x) < Epsilon()) & (simd::Abs(m_y - other.m_y) < Epsilon());
+        }
+
+    protected:
+        T m_x;
+        T m_y;
+    };
+
+    template <typename T>
+    inline Vec2<T> operator*(const T &ratio, const Vec2<T> &vec)
+    {
+        return vec * ratio;
+    }
+
+    typedef Vec2<float> Vec2f;
+    typedef Vec2<double> Vec2d;
+    typedef Vec2<PackF4> Vec2x4;
+    typedef Vec2<PackF8> Vec2x8;
+
+} // namespace auto_parking_planning
+
+#endif /* __VEC2_H__ */
@@ -0,0 +1,77 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-19 21:40:05
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-19 21:40:05
+ */
+
+#ifndef __XVIZ_CONVERT_H__
+#define __XVIZ_CONVERT_H__
+
+#include "common/span.h"
+#include "data_types.h"
+#include "vec2.h"
+#include <cstddef>
+#include <type_traits>
+
+// 规划几何类型与 xviz 消息类型之间的转换.
+// 两者都是两个紧凑排列的 float, 按值转换在优化后只是寄存器搬运;
+// 数组不做拷贝, 通过视图在访问时逐点转换
+namespace auto_parking_planning
+{
+    static_assert(sizeof(Vec2f) == sizeof(xviz::Vec2f) && std::is_trivially_copyable<Vec2f>::value,
+                  "Vec2f and xviz::Vec2f must share a layout");
+
+    inline Vec2f FromXviz(const xviz::Vec2f &v) { return Vec2f(v.x, v.y); }
+
+    inline Vec2f FromXviz(const xviz::PointXYZ &p) { return Vec2f(p.x, p.y); }
+
+    inline Vec2f PositionOf(const xviz::Pose &pose) { return Vec2f(pose.x, pose.y); }
+
+    inline xviz::Vec2f ToXviz(const Vec2f &v) { return xviz::Vec2f(v.x(), v.y()); }
+
+    /// @brief xviz 点数组的只读视图, 下标访问得到 Vec2f, 不拷贝底层数据
+    template <typename Source>
+    class XvizPointView
+    {
+    public:
+        XvizPointView() = default;
+
+        XvizPointView(const Source *data, const size_t size) : m_data(data), m_size(size) {}
+
+        XvizPointView(const Span<Source> &span) : m_data(span.data()), m_size(span.size()) {}
+
+        size_t size() const { return m_size; }
+
+        bool empty() const { return m_size == 0; }
+
+        Vec2f operator[](const size_t i) const { return FromXviz(m_data[i]); }
+
+        /// @brief 从 first 开始取 N 个点组成数值包, 越界通道复制最后一个点
+        template <int N>
+        Vec2<Pack<float, N>> LoadPack(const size_t first) const
+        {
+            Vec2<Pack<float, N>> out;
+            Pack<float, N> xs, ys;
+            for (int i = 0; i < N; ++i)
+            {
+                const size_t k = first + i < m_size ? first + i : m_size - 1;
+                xs[i] = m_data[k].x;
+                ys[i] = m_data[k].y;
+            }
+            out.SetX(xs);
+            out.SetY(ys);
+            return out;
+        }
+
+    private:
+        const Source *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    typedef XvizPointView<xviz::Vec2f> XvizVec2View;
+    typedef XvizPointView<xviz::PointXYZ> XvizCloudView;
+
+} // namespace auto_parking_planning
+
+#endif /* __XVIZ_CONVERT_H__ */
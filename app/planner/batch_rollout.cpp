@@ -0,0 +1,179 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 15:58:44
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 15:58:44
+ */
+#include "batch_rollout.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kStraightCurvature = 1e-6f;
+        constexpr float kPi = static_cast<float>(M_PI);
+    }
+
+    void BatchRollout::Run(const std::vector<RolloutCandidate> &candidates, const int steps)
+    {
+        const size_t count = candidates.size();
+        Reset(count, steps);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_forward[i] = candidates[i].ds >= 0.0f ? 1 : 0;
+        }
+        for (size_t first = 0; first < count; first += kLanes)
+        {
+            RunGroup(candidates, first);
+        }
+    }
+
+    void BatchRollout::Run(const LatticeView &lattice, const float x, const float y, const float yaw)
+    {
+        const int count = lattice.Primitives();
+        Reset(count, lattice.steps);
+        for (int i = 0; i < count; ++i)
+        {
+            m_forward[i] = i < lattice.steerSamples ? 1 : 0;
+        }
+        // 整个节点只需这一次三角函数
+        const float c = cosf(yaw);
+        const float s = sinf(yaw);
+        for (int first = 0; first < count; first += kLanes)
+        {
+            RunLatticeGroup(lattice, first, x, y, yaw, c, s);
+        }
+    }
+
+    void BatchRollout::Reset(const size_t count, const int steps)
+    {
+        m_steps = std::max(0, steps);
+        m_x.resize(count * m_steps);
+        m_y.resize(count * m_steps);
+        m_yaw.resize(count * m_steps);
+        m_validSteps.assign(count, 0);
+        m_forward.resize(count);
+    }
+
+    void BatchRollout::RunGroup(const std::vector<RolloutCandidate> &candidates, const size_t first)
+    {
+        const int lanes = static_cast<int>(std::min<size_t>(kLanes, candidates.size() - first));
+        // 每步在车体系下的位移 (lx, ly) 与航向增量的旋转 (rc, rs), 空闲通道复制第一条候选
+        PackF8 x, y, yaw, c, s, lx, ly, rc, rs, dyaw;
+        PackF8::Mask active;
+        for (int k = 0; k < kLanes; ++k)
+        {
+            const RolloutCandidate &cand = candidates[first + std::min(k, lanes - 1)];
+            const float step_yaw = cand.curvature * cand.ds;
+            x[k] = cand.x;
+            y[k] = cand.y;
+            yaw[k] = cand.yaw;
+            c[k] = cosf(cand.yaw);
+            s[k] = sinf(cand.yaw);
+            rc[k] = cosf(step_yaw);
+            rs[k] = sinf(step_yaw);
+            dyaw[k] = step_yaw;
+            if (std::fabs(cand.curvature) < kStraightCurvature)
+            {
+                lx[k] = cand.ds;
+                ly[k] = 0.0f;
+            }
+            else
+            {
+                lx[k] = rs[k] / cand.curvature;
+                ly[k] = (1.0f - rc[k]) / cand.curvature;
+            }
+            active.lanes[k] = k < lanes;
+        }
+
+        const PackF8 pi(kPi);
+        const PackF8 two_pi(2.0f * kPi);
+        for (int step = 0; step < m_steps; ++step)
+        {
+            x += c * lx - s * ly;
+            y += s * lx + c * ly;
+            const PackF8 nc = c * rc - s * rs;
+            s = s * rc + c * rs;
+            c = nc;
+            yaw += dyaw;
+            yaw = simd::Select(yaw >= pi, yaw - two_pi, simd::Select(yaw < -pi, yaw + two_pi, yaw));
+
+            active = m_checker->IsFree(x, y, c, s, active);
+            Store(first, lanes, step, x, y, yaw, active);
+            if (!simd::Any(active))
+            {
+                break;
+            }
+        }
+    }
+
+    void BatchRollout::RunLatticeGroup(const LatticeView &lattice, const int first, const float x0,
+                                       const float y0, const float yaw0, const float c0, const float s0)
+    {
+        const int lanes = std::min(kLanes, lattice.Primitives() - first);
+        const PackF8 pi(kPi);
+        const PackF8 two_pi(2.0f * kPi);
+        PackF8::Mask active;
+        for (int k = 0; k < kLanes; ++k)
+        {
+            active.lanes[k] = k < lanes;
+        }
+        for (int step = 0; step < m_steps; ++step)
+        {
+            // 车体系增量旋转到起点航向后平移, 空闲通道复制第一条基元
+            PackF8 x, y, yaw, c, s;
+            for (int k = 0; k < kLanes; ++k)
+            {
+                const LatticeSample &sample = lattice.At(first + std::min(k, lanes - 1), step);
+                x[k] = x0 + c0 * sample.dx - s0 * sample.dy;
+                y[k] = y0 + s0 * sample.dx + c0 * sample.dy;
+                yaw[k] = yaw0 + sample.dyaw;
+                c[k] = c0 * sample.cosYaw - s0 * sample.sinYaw;
+                s[k] = s0 * sample.cosYaw + c0 * sample.sinYaw;
+            }
+            yaw = simd::Select(yaw >= pi, yaw - two_pi, simd::Select(yaw < -pi, yaw + two_pi, yaw));
+
+            active = m_checker->IsFree(x, y, c, s, active);
+            Store(first, lanes, step, x, y, yaw, active);
+            if (!simd::Any(active))
+            {
+                break;
+            }
+        }
+    }
+
+    void BatchRollout::Store(const size_t first, const int lanes, const int step, const PackF8 &x,
+                             const PackF8 &y, const PackF8 &yaw, const PackF8::Mask &active)
+    {
+        for (int k = 0; k < lanes; ++k)
+        {
+            if (active.lanes[k])
+            {
+                const size_t index = (first + k) * m_steps + step;
+                m_x[index] = x[k];
+                m_y[index] = y[k];
+                m_yaw[index] = yaw[k];
+                ++m_validSteps[first + k];
+            }
+        }
+    }
+
+    void BatchRollout::Trace(const size_t candidate, std::vector<PathPoint> *trace) const
+    {
+        trace->clear();
+        const size_t base = candidate * m_steps;
+        for (int step = 0; step < m_validSteps[candidate]; ++step)
+        {
+            PathPoint pt;
+            pt.x = m_x[base + step];
+            pt.y = m_y[base + step];
+            pt.yaw = m_yaw[base + step];
+            pt.forward = m_forward[candidate] != 0;
+            trace->push_back(pt);
+        }
+    }
+
+} // namespace auto_parking_planning
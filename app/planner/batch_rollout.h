@@ -0,0 +1,81 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 15:27:10
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 15:27:10
+ */
+
+#ifndef __BATCH_ROLLOUT_H__
+#define __BATCH_ROLLOUT_H__
+
+#include "collision_checker.h"
+#include "math/simd_pack.h"
+#include "planner_types.h"
+#include "primitive_lattice.h"
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 一条候选的运动学参数, 以恒定曲率走 steps 步, 每步弧长 ds(倒车为负)
+    struct RolloutCandidate
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float yaw = 0.0f;
+        float curvature = 0.0f;
+        float ds = 0.0f;
+    };
+
+    /// @brief 自行车模型批量积分. 候选按 8 条一组以 SoA 数值包同步推进,
+    /// 每步的位移与航向旋转在开始时按候选预先算好, 积分过程只有乘加, 不调用三角函数;
+    /// 每步随即做批量碰撞检测, 碰撞的通道退出, 整组都退出后提前结束
+    class BatchRollout
+    {
+    public:
+        static constexpr int kLanes = PackF8::kLanes;
+
+        explicit BatchRollout(const CollisionChecker *checker) : m_checker(checker) {}
+
+        /// @brief 积分全部候选, 之后以候选下标查询结果
+        void Run(const std::vector<RolloutCandidate> &candidates, const int steps);
+
+        /// @brief 以基元表生成起点 (x, y, yaw) 的全部子节点, 候选下标即基元下标.
+        /// 采样点由查表旋转平移得到, 不做积分
+        void Run(const LatticeView &lattice, const float x, const float y, const float yaw);
+
+        /// @brief 候选是否走完全部步数且无碰撞
+        bool Valid(const size_t candidate) const { return m_validSteps[candidate] == m_steps; }
+
+        /// @brief 候选在碰撞前走过的步数
+        int ValidSteps(const size_t candidate) const { return m_validSteps[candidate]; }
+
+        /// @brief 取出候选的有效采样点, 不含起点
+        void Trace(const size_t candidate, std::vector<PathPoint> *trace) const;
+
+    private:
+        void Reset(const size_t count, const int steps);
+
+        void RunGroup(const std::vector<RolloutCandidate> &candidates, const size_t first);
+
+        void RunLatticeGroup(const LatticeView &lattice, const int first, const float x, const float y,
+                             const float yaw, const float cos_yaw, const float sin_yaw);
+
+        /// @brief 记录本步仍有效通道的位姿
+        void Store(const size_t first, const int lanes, const int step, const PackF8 &x, const PackF8 &y,
+                   const PackF8 &yaw, const PackF8::Mask &active);
+
+    private:
+        const CollisionChecker *m_checker;
+        int m_steps = 0;
+        /// 第 i 条候选第 j 步位于 [i * m_steps + j]
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_yaw;
+        std::vector<int> m_validSteps;
+        std::vector<uint8_t> m_forward;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __BATCH_ROLLOUT_H__ */
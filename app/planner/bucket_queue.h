@@ -0,0 +1,156 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-16 20:14:37
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-16 20:14:37
+ */
+
+#ifndef __BUCKET_QUEUE_H__
+#define __BUCKET_QUEUE_H__
+
+#include "common/index_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 开放列表用的桶式优先队列. 代价按 resolution 量化后落入桶中,
+    /// 桶内以节点索引为句柄组成双向链表, 因此插入、降低/提高代价、删除均为 O(1).
+    /// 搜索中最小代价基本单调不减, 出队时游标只需向前扫描;
+    /// 若插入的代价低于游标, 游标回退即可, 不要求严格单调.
+    /// 量化后超过 kOverflowBucket 的代价(含无穷大与 NaN)同放最后一桶, 桶内不再排序
+    class BucketQueue
+    {
+    public:
+        /// 桶数上限, 头指针数组最多约 4 MB
+        static constexpr uint32_t kOverflowBucket = 1u << 20;
+
+        explicit BucketQueue(const float resolution = 0.02f) : m_invRes(1.0f / resolution) {}
+
+        void SetResolution(const float resolution) { m_invRes = 1.0f / resolution; }
+
+        bool Empty() const { return m_size == 0; }
+
+        size_t Size() const { return m_size; }
+
+        /// @brief 清空, 只复位用到过的桶
+        void Clear()
+        {
+            if (m_topBucket >= 0)
+            {
+                std::fill(m_heads.begin(), m_heads.begin() + m_topBucket + 1, kInvalidIndex);
+            }
+            m_topBucket = -1;
+            m_cursor = 0;
+            m_size = 0;
+        }
+
+        /// @brief 插入句柄, 句柄不能已在队列中
+        void Push(const uint32_t handle, const float key)
+        {
+            if (handle >= m_links.size())
+            {
+                m_links.resize(std::max<size_t>(handle + 1, 2 * m_links.size()));
+            }
+            Link(handle, Bucket(key));
+            ++m_size;
+        }
+
+        /// @brief 修改队列中句柄的代价, 升降均可
+        void Update(const uint32_t handle, const float key)
+        {
+            const uint32_t bucket = Bucket(key);
+            if (bucket == m_links[handle].bucket)
+            {
+                return;
+            }
+            Unlink(handle);
+            Link(handle, bucket);
+        }
+
+        /// @brief 弹出最小代价桶中的一个句柄, 队列不能为空
+        uint32_t Pop()
+        {
+            while (m_heads[m_cursor] == kInvalidIndex)
+            {
+                ++m_cursor;
+            }
+            const uint32_t handle = m_heads[m_cursor];
+            Unlink(handle);
+            --m_size;
+            return handle;
+        }
+
+    private:
+        struct Links
+        {
+            uint32_t prev = kInvalidIndex;
+            uint32_t next = kInvalidIndex;
+            uint32_t bucket = kInvalidIndex;
+        };
+
+        uint32_t Bucket(const float key) const
+        {
+            const float scaled = key * m_invRes;
+            // NaN 的比较恒为假, 与过大的代价一起落入溢出桶
+            if (!(scaled < static_cast<float>(kOverflowBucket)))
+            {
+                return kOverflowBucket;
+            }
+            return static_cast<uint32_t>(std::max(0.0f, scaled));
+        }
+
+        void Link(const uint32_t handle, const uint32_t bucket)
+        {
+            if (static_cast<int64_t>(bucket) > m_topBucket)
+            {
+                if (bucket >= m_heads.size())
+                {
+                    m_heads.resize(std::max<size_t>(bucket + 1, 2 * m_heads.size()), kInvalidIndex);
+                }
+                m_topBucket = bucket;
+            }
+            Links &links = m_links[handle];
+            links.bucket = bucket;
+            links.prev = kInvalidIndex;
+            links.next = m_heads[bucket];
+            if (links.next != kInvalidIndex)
+            {
+                m_links[links.next].prev = handle;
+            }
+            m_heads[bucket] = handle;
+            m_cursor = std::min(m_cursor, bucket);
+        }
+
+        void Unlink(const uint32_t handle)
+        {
+            Links &links = m_links[handle];
+            if (links.prev != kInvalidIndex)
+            {
+                m_links[links.prev].next = links.next;
+            }
+            else
+            {
+                m_heads[links.bucket] = links.next;
+            }
+            if (links.next != kInvalidIndex)
+            {
+                m_links[links.next].prev = links.prev;
+            }
+            links.bucket = kInvalidIndex;
+        }
+
+    private:
+        float m_invRes;
+        std::vector<uint32_t> m_heads;
+        std::vector<Links> m_links;
+        int64_t m_topBucket = -1;
+        uint32_t m_cursor = 0;
+        size_t m_size = 0;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __BUCKET_QUEUE_H__ */
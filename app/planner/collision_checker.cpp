@@ -0,0 +1,398 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 21:22:05
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 21:22:05
+ */
+#include "collision_checker.h"
+#include "common/profiler.h"
+#include "map/grid_map_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        // 栅格中心到栅格角点的距离系数
+        constexpr float kHalfCellDiagonal = 0.7072f;
+        // 粗判定所在层上包围盒每个方向最多跨越的栅格数
+        constexpr int kCoarseSpan = 4;
+    }
+
+    CollisionChecker::CollisionChecker(const VehicleParam &vehicle, const float safety_margin,
+                                       const bool coarse_to_fine)
+        : m_vehicle(vehicle), m_margin(safety_margin), m_coarseToFine(coarse_to_fine)
+    {
+        const int n = std::max(1, static_cast<int>(std::ceil(vehicle.length / vehicle.width)));
+        const float step = vehicle.length / n;
+        for (int i = 0; i < n; ++i)
+        {
+            m_circleOffsets.push_back(-vehicle.rearOverhang + (i + 0.5f) * step);
+        }
+        m_circleRadius = hypotf(0.5f * step, 0.5f * vehicle.width);
+    }
+
+    void CollisionChecker::SetMap(const xviz::GridMap &map)
+    {
+        m_map = map;
+        m_originCos = cosf(map.m_originYaw);
+        m_originSin = sinf(map.m_originYaw);
+        m_esdf.Build(map);
+        m_pyramid.Build(map);
+        ++m_generation;
+    }
+
+    void CollisionChecker::UpdateCells(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed)
+    {
+        m_esdf.Update(occupied, freed);
+        for (const xviz::Vec2i &cell : freed)
+        {
+            m_pyramid.Set(cell.x, cell.y, false);
+        }
+        for (const xviz::Vec2i &cell : occupied)
+        {
+            m_pyramid.Set(cell.x, cell.y, true);
+        }
+        ++m_generation;
+    }
+
+    float CollisionChecker::Clearance(const float x, const float y) const
+    {
+        float gx, gy;
+        WorldToGrid(m_map, x, y, &gx, &gy);
+        return m_esdf.Distance(static_cast<int>(std::floor(gx)), static_cast<int>(std::floor(gy)));
+    }
+
+    bool CollisionChecker::IsFree(const float x, const float y, const float yaw) const
+    {
+        ++m_checkCount;
+        APP_PROFILE_COUNT(ProfileChannel::COLLISION_CHECKS, 1);
+        float gx, gy;
+        WorldToGrid(m_map, x, y, &gx, &gy);
+        // 相对栅格坐标系的航向
+        const float c = cosf(yaw) * m_originCos + sinf(yaw) * m_originSin;
+        const float s = sinf(yaw) * m_originCos - cosf(yaw) * m_originSin;
+
+        if (m_coarseToFine && CoarseFree(gx, gy, c, s))
+        {
+            return true;
+        }
+
+        const float inv_res = 1.0f / m_map.m_res;
+        const float required = m_circleRadius + m_margin + kHalfCellDiagonal * m_map.m_res;
+        bool circles_free = true;
+        for (const float offset : m_circleOffsets)
+        {
+            const float cx = gx + c * offset * inv_res;
+            const float cy = gy + s * offset * inv_res;
+            if (m_esdf.Distance(static_cast<int>(std::floor(cx)), static_cast<int>(std::floor(cy))) <= required)
+            {
+                circles_free = false;
+                break;
+            }
+        }
+        if (circles_free)
+        {
+            return true;
+        }
+        return FootprintFree(gx, gy, c, s);
+    }
+
+    PackF8::Mask CollisionChecker::IsFree(const PackF8 &x, const PackF8 &y, const PackF8 &cos_yaw,
+                                          const PackF8 &sin_yaw, const PackF8::Mask &active) const
+    {
+        uint32_t checks = 0;
+        for (int k = 0; k < PackF8::kLanes; ++k)
+        {
+            checks += active.lanes[k] ? 1 : 0;
+        }
+        AddCheckCount(checks);
+        return IsFreeUncounted(x, y, cos_yaw, sin_yaw, active);
+    }
+
+    void CollisionChecker::AddCheckCount(const uint32_t checks) const
+    {
+        m_checkCount += checks;
+        APP_PROFILE_COUNT(ProfileChannel::COLLISION_CHECKS, checks);
+    }
+
+    PackF8::Mask CollisionChecker::IsFreeUncounted(const PackF8 &x, const PackF8 &y, const PackF8 &cos_yaw,
+                                                   const PackF8 &sin_yaw, const PackF8::Mask &active) const
+    {
+        const float inv_res = 1.0f / m_map.m_res;
+        const PackF8 dx = x - PackF8(m_map.m_origin.x);
+        const PackF8 dy = y - PackF8(m_map.m_origin.y);
+        const PackF8 gx = (PackF8(m_originCos) * dx + PackF8(m_originSin) * dy) * PackF8(inv_res);
+        const PackF8 gy = (PackF8(m_originCos) * dy - PackF8(m_originSin) * dx) * PackF8(inv_res);
+        const PackF8 c = cos_yaw * PackF8(m_originCos) + sin_yaw * PackF8(m_originSin);
+        const PackF8 s = sin_yaw * PackF8(m_originCos) - cos_yaw * PackF8(m_originSin);
+
+        // 粗层上包围盒为空的通道直接通过, 不再访问距离场
+        PackF8::Mask coarse_free;
+        for (int k = 0; k < PackF8::kLanes; ++k)
+        {
+            coarse_free.lanes[k] = m_coarseToFine && active.lanes[k] && CoarseFree(gx[k], gy[k], c[k], s[k]);
+        }
+
+        const float required = m_circleRadius + m_margin + kHalfCellDiagonal * m_map.m_res;
+        const int width = m_esdf.Width();
+        const int height = m_esdf.Height();
+        const float *esdf = m_esdf.Data();
+        PackF8::Mask circles_free = active;
+        for (int k = 0; k < PackF8::kLanes; ++k)
+        {
+            circles_free.lanes[k] = active.lanes[k] && !coarse_free.lanes[k];
+        }
+        for (const float offset : m_circleOffsets)
+        {
+            const PackF8 cx = gx + c * PackF8(offset * inv_res);
+            const PackF8 cy = gy + s * PackF8(offset * inv_res);
+            // 取整与越界判断无分支, 可向量化; 之后逐通道查距离场, 越界按距离 0 处理
+            int32_t index[PackF8::kLanes];
+            bool inside[PackF8::kLanes];
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                int32_t ix = static_cast<int32_t>(cx[k]);
+                int32_t iy = static_cast<int32_t>(cy[k]);
+                ix -= cx[k] < static_cast<float>(ix) ? 1 : 0;
+                iy -= cy[k] < static_cast<float>(iy) ? 1 : 0;
+                inside[k] = (ix >= 0) & (iy >= 0) & (ix < width) & (iy < height);
+                index[k] = inside[k] ? iy * width + ix : 0;
+            }
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                circles_free.lanes[k] = circles_free.lanes[k] && inside[k] && esdf[index[k]] > required;
+            }
+        }
+
+        PackF8::Mask free = circles_free;
+        for (int k = 0; k < PackF8::kLanes; ++k)
+        {
+            if (coarse_free.lanes[k])
+            {
+                free.lanes[k] = true;
+            }
+            else if (active.lanes[k] && !circles_free.lanes[k])
+            {
+                free.lanes[k] = FootprintFree(gx[k], gy[k], c[k], s[k]);
+            }
+        }
+        return free;
+    }
+
+    void CollisionChecker::ComputeBox(const float gx, const float gy, const float c, const float s,
+                                      FootprintBox *box) const
+    {
+        const float inv_res = 1.0f / m_map.m_res;
+        const float inflate = m_margin * inv_res + kHalfCellDiagonal;
+        // 车体矩形(栅格单位, 车体坐标系)
+        box->minX = -m_vehicle.rearOverhang * inv_res - inflate;
+        box->maxX = m_vehicle.FrontToRear() * inv_res + inflate;
+        box->halfW = 0.5f * m_vehicle.width * inv_res + inflate;
+
+        float lo_x = gx, hi_x = gx, lo_y = gy, hi_y = gy;
+        const float corners[4][2] = {
+            {box->minX, -box->halfW}, {box->minX, box->halfW}, {box->maxX, -box->halfW}, {box->maxX, box->halfW}};
+        for (const auto &corner : corners)
+        {
+            const float px = gx + c * corner[0] - s * corner[1];
+            const float py = gy + s * corner[0] + c * corner[1];
+            lo_x = std::min(lo_x, px);
+            hi_x = std::max(hi_x, px);
+            lo_y = std::min(lo_y, py);
+            hi_y = std::max(hi_y, py);
+        }
+        box->x0 = static_cast<int>(std::floor(lo_x));
+        box->x1 = static_cast<int>(std::floor(hi_x));
+        box->y0 = static_cast<int>(std::floor(lo_y));
+        box->y1 = static_cast<int>(std::floor(hi_y));
+        box->inside = box->x0 >= 0 && box->y0 >= 0 && box->x1 < GridWidth(m_map) && box->y1 < GridHeight(m_map);
+    }
+
+    bool CollisionChecker::CoarseFree(const float gx, const float gy, const float c, const float s) const
+    {
+        FootprintBox box;
+        ComputeBox(gx, gy, c, s, &box);
+        if (!box.inside)
+        {
+            return false;
+        }
+        // 取包围盒每个方向最多跨 kCoarseSpan 个栅格的一层, 该层数据量小, 通常在缓存中
+        int level = 0;
+        while (level + 1 < m_pyramid.Levels() &&
+               ((box.x1 >> level) - (box.x0 >> level) >= kCoarseSpan ||
+                (box.y1 >> level) - (box.y0 >> level) >= kCoarseSpan))
+        {
+            ++level;
+        }
+        return !m_pyramid.Level(level).AnyInBox(box.x0 >> level, box.y0 >> level, box.x1 >> level,
+                                                box.y1 >> level);
+    }
+
+    bool CollisionChecker::FootprintFree(const float gx, const float gy, const float c, const float s) const
+    {
+        FootprintBox box;
+        ComputeBox(gx, gy, c, s, &box);
+        if (!box.inside)
+        {
+            return false;
+        }
+        const float min_x = box.minX;
+        const float max_x = box.maxX;
+        const float half_w = box.halfW;
+        const int x0 = box.x0, x1 = box.x1, y0 = box.y0, y1 = box.y1;
+        if (m_coarseToFine)
+        {
+            return PyramidFree(gx, gy, c, s, box);
+        }
+
+        // 按 8x8 块整字取出包围盒内的占据位, 空块只需一次读取, 只对置位的栅格做矩形判断
+        const BitGrid &bits = m_pyramid.Level(0);
+        const int tx0 = x0 >> BitGrid::kTileShift, tx1 = x1 >> BitGrid::kTileShift;
+        const int ty0 = y0 >> BitGrid::kTileShift, ty1 = y1 >> BitGrid::kTileShift;
+        const int tile_mask = BitGrid::kTileSize - 1;
+        for (int ty = ty0; ty <= ty1; ++ty)
+        {
+            const int ly0 = ty == ty0 ? y0 & tile_mask : 0;
+            const int ly1 = ty == ty1 ? y1 & tile_mask : tile_mask;
+            for (int tx = tx0; tx <= tx1; ++tx)
+            {
+                const int lx0 = tx == tx0 ? x0 & tile_mask : 0;
+                const int lx1 = tx == tx1 ? x1 & tile_mask : tile_mask;
+                uint64_t word = bits.Tile(tx, ty) & BitGrid::BoxMask(lx0, lx1, ly0, ly1);
+                while (word != 0)
+                {
+                    const int bit = LowestSetBit(word);
+                    word &= word - 1;
+                    const float dx = ((tx << BitGrid::kTileShift) | (bit & tile_mask)) + 0.5f - gx;
+                    const float dy = ((ty << BitGrid::kTileShift) | (bit >> BitGrid::kTileShift)) + 0.5f - gy;
+                    const float lx = c * dx + s * dy;
+                    const float ly = -s * dx + c * dy;
+                    if (lx >= min_x && lx <= max_x && std::fabs(ly) <= half_w)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool CollisionChecker::PyramidFree(const float gx, const float gy, const float c, const float s,
+                                       const FootprintBox &box) const
+    {
+        const float min_x = box.minX;
+        const float max_x = box.maxX;
+        const float half_w = box.halfW;
+        const int x0 = box.x0, x1 = box.x1, y0 = box.y0, y1 = box.y1;
+        const int width = GridWidth(m_map);
+        const int height = GridHeight(m_map);
+
+        // 从包围盒每个方向最多跨两个栅格的一层开始, 空的粗栅格整块跳过; 与矩形不相交的跳过,
+        // 整块落在矩形内的直接判为碰撞, 只有跨越矩形边界的占据块才继续细分.
+        // 细分到 8x8 块时按整字取出占据位, 只对置位的栅格做矩形判断
+        int start_level = 0;
+        while (start_level + 1 < m_pyramid.Levels() &&
+               ((x1 >> start_level) - (x0 >> start_level) > 1 || (y1 >> start_level) - (y0 >> start_level) > 1))
+        {
+            ++start_level;
+        }
+        struct Block
+        {
+            int level, x, y;
+        };
+        // 每次细分至多压入 4 个子块, 栈深不超过 4 + 3 * 层数
+        Block stack[4 + 3 * 32];
+        int top = 0;
+        for (int y = y0 >> start_level; y <= y1 >> start_level; ++y)
+        {
+            for (int x = x0 >> start_level; x <= x1 >> start_level; ++x)
+            {
+                if (m_pyramid.Occupied(start_level, x, y))
+                {
+                    stack[top++] = {start_level, x, y};
+                }
+            }
+        }
+
+        // 块判定留出容差, 边界上的情形交给逐栅格判断, 保证与逐栅格检测结果一致
+        constexpr float kEps = 1e-3f;
+        const int tile_mask = BitGrid::kTileSize - 1;
+        const BitGrid &cells = m_pyramid.Level(0);
+        while (top > 0)
+        {
+            const Block block = stack[--top];
+            const int bx0 = std::max(block.x << block.level, x0);
+            const int by0 = std::max(block.y << block.level, y0);
+            const int bx1 = std::min(((block.x + 1) << block.level) - 1, x1);
+            const int by1 = std::min(((block.y + 1) << block.level) - 1, y1);
+            if (bx0 > bx1 || by0 > by1)
+            {
+                continue;
+            }
+
+            // 块内栅格中心构成的矩形在车体系下的投影范围
+            const float mx = 0.5f * (bx0 + bx1) + 0.5f - gx;
+            const float my = 0.5f * (by0 + by1) + 0.5f - gy;
+            const float hx = 0.5f * (bx1 - bx0);
+            const float hy = 0.5f * (by1 - by0);
+            const float lx = c * mx + s * my;
+            const float ly = -s * mx + c * my;
+            const float ex = std::fabs(c) * hx + std::fabs(s) * hy;
+            const float ey = std::fabs(s) * hx + std::fabs(c) * hy;
+            if (lx + ex < min_x - kEps || lx - ex > max_x + kEps || ly - ey > half_w + kEps ||
+                ly + ey < -half_w - kEps)
+            {
+                continue;
+            }
+            // 占据块只有完整在包围盒内时, 才能确定占据的栅格落在矩形内
+            const bool whole = bx0 == block.x << block.level && by0 == block.y << block.level &&
+                               bx1 == std::min(((block.x + 1) << block.level) - 1, width - 1) &&
+                               by1 == std::min(((block.y + 1) << block.level) - 1, height - 1);
+            if (whole && lx - ex >= min_x + kEps && lx + ex <= max_x - kEps && std::fabs(ly) + ey <= half_w - kEps)
+            {
+                return false;
+            }
+
+            if (block.level <= BitGrid::kTileShift)
+            {
+                const int tx = bx0 >> BitGrid::kTileShift;
+                const int ty = by0 >> BitGrid::kTileShift;
+                uint64_t word = cells.Tile(tx, ty) &
+                                BitGrid::BoxMask(bx0 & tile_mask, bx1 & tile_mask, by0 & tile_mask, by1 & tile_mask);
+                while (word != 0)
+                {
+                    const int bit = LowestSetBit(word);
+                    word &= word - 1;
+                    const float dx = ((tx << BitGrid::kTileShift) | (bit & tile_mask)) + 0.5f - gx;
+                    const float dy = ((ty << BitGrid::kTileShift) | (bit >> BitGrid::kTileShift)) + 0.5f - gy;
+                    const float cell_x = c * dx + s * dy;
+                    const float cell_y = -s * dx + c * dy;
+                    if (cell_x >= min_x && cell_x <= max_x && std::fabs(cell_y) <= half_w)
+                    {
+                        return false;
+                    }
+                }
+                continue;
+            }
+
+            const int child = block.level - 1;
+            const BitGrid &level = m_pyramid.Level(child);
+            for (int j = 1; j >= 0; --j)
+            {
+                for (int i = 1; i >= 0; --i)
+                {
+                    const int cx = 2 * block.x + i;
+                    const int cy = 2 * block.y + j;
+                    if (cx < level.Width() && cy < level.Height() && level.Occupied(cx, cy))
+                    {
+                        stack[top++] = {child, cx, cy};
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,114 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 21:03:44
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 21:03:44
+ */
+
+#ifndef __COLLISION_CHECKER_H__
+#define __COLLISION_CHECKER_H__
+
+#include "common/span.h"
+#include "data_types.h"
+#include "map/distance_field.h"
+#include "map/occupancy_pyramid.h"
+#include "math/simd_pack.h"
+#include "vehicle_param.h"
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 车辆轮廓碰撞检测
+    /// 先用覆盖圆在距离场上快速判定, 覆盖圆不通过时再在位压缩栅格上对矩形轮廓精确检测
+    class CollisionChecker
+    {
+    public:
+        /// @param coarse_to_fine 先在占据金字塔的粗层上判断包围盒是否为空, 精确检测也由粗到细进行;
+        /// 大面积空旷的地图上可省去距离场访问, 障碍物密集时反而更慢, 默认关闭
+        explicit CollisionChecker(const VehicleParam &vehicle = VehicleParam(), const float safety_margin = 0.1f,
+                                  const bool coarse_to_fine = false);
+
+        /// @brief 设置地图并重建距离场, map.m_data 需在使用期间保持有效
+        void SetMap(const xviz::GridMap &map);
+
+        /// @brief 动态障碍物引起的局部变化: 增量更新距离场与占据金字塔, 不读取 map.m_data.
+        /// 调用方需自行维护原栅格数据, 之后的 Map().m_data 不再反映这些变化
+        void UpdateCells(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed);
+
+        /// @brief 后轴中心位姿(世界系)是否无碰撞
+        bool IsFree(const float x, const float y, const float yaw) const;
+
+        /// @brief 8 个位姿的批量检测, 航向以单位向量给出. 覆盖圆判定逐通道并行,
+        /// 只有覆盖圆不通过的通道再做精确检测; 返回 active 中无碰撞的通道
+        PackF8::Mask IsFree(const PackF8 &x, const PackF8 &y, const PackF8 &cos_yaw, const PackF8 &sin_yaw,
+                            const PackF8::Mask &active) const;
+
+        /// @brief 同批量 IsFree, 但不累计检测次数, 可在多个线程中并发调用
+        PackF8::Mask IsFreeUncounted(const PackF8 &x, const PackF8 &y, const PackF8 &cos_yaw,
+                                     const PackF8 &sin_yaw, const PackF8::Mask &active) const;
+
+        /// @brief 并发检测结束后由调用线程补记检测次数
+        void AddCheckCount(const uint32_t checks) const;
+
+        /// @brief 世界坐标处到最近障碍物的距离
+        float Clearance(const float x, const float y) const;
+
+        const VehicleParam &Vehicle() const { return m_vehicle; }
+
+        const xviz::GridMap &Map() const { return m_map; }
+
+        const DistanceField &Esdf() const { return m_esdf; }
+
+        /// @brief 位压缩的占据栅格, 精确检测使用
+        const BitGrid &Occupancy() const { return m_pyramid.Level(0); }
+
+        /// @brief 占据栅格的最大池化金字塔
+        const OccupancyPyramid &Pyramid() const { return m_pyramid; }
+
+        /// @brief 每次 SetMap 或 UpdateCells 加一, 供依赖地图的缓存判断失效
+        uint64_t MapGeneration() const { return m_generation; }
+
+        uint32_t CheckCount() const { return m_checkCount; }
+
+        void ResetCheckCount() { m_checkCount = 0; }
+
+    private:
+        /// 车体矩形(栅格单位, 车体坐标系)及其在栅格上的包围盒
+        struct FootprintBox
+        {
+            float minX, maxX, halfW;
+            int x0, y0, x1, y1;
+            bool inside;
+        };
+
+        void ComputeBox(const float gx, const float gy, const float cos_yaw, const float sin_yaw,
+                        FootprintBox *box) const;
+
+        /// @brief 在金字塔粗层上判断包围盒是否为空, 为空则必然无碰撞
+        bool CoarseFree(const float gx, const float gy, const float cos_yaw, const float sin_yaw) const;
+
+        bool FootprintFree(const float gx, const float gy, const float cos_yaw, const float sin_yaw) const;
+
+        /// @brief 在金字塔上由粗到细的精确检测, 结果与逐块检测一致
+        bool PyramidFree(const float gx, const float gy, const float cos_yaw, const float sin_yaw,
+                         const FootprintBox &box) const;
+
+    private:
+        VehicleParam m_vehicle;
+        float m_margin;
+        bool m_coarseToFine;
+        xviz::GridMap m_map;
+        DistanceField m_esdf;
+        OccupancyPyramid m_pyramid;
+        float m_originCos = 1.0f;
+        float m_originSin = 0.0f;
+        std::vector<float> m_circleOffsets;
+        float m_circleRadius = 0.0f;
+        uint64_t m_generation = 0;
+        mutable uint32_t m_checkCount = 0;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __COLLISION_CHECKER_H__ */
@@ -0,0 +1,269 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 21:05:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 21:05:12
+ */
+#include "geometric_planner.h"
+#include "math/line_segment2f.h"
+#include <algorithm>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kHalfPi = static_cast<float>(0.5 * M_PI);
+        /// 起点航向与库位轴线的夹角正弦小于该值时, 单圆弧的切点在无穷远处
+        constexpr float kMinSinYaw = 0.05f;
+        constexpr float kMinSegmentLength = 1e-3f;
+        /// 终点与目标的允许误差, 只用于剔除几何上不成立的解
+        constexpr float kEndPositionTolerance = 1e-2f;
+        constexpr float kEndYawTolerance = 1e-2f;
+        constexpr size_t kCoarseStride = 8;
+
+        /// @brief 以恒定曲率走 length, 曲率为 0 时走直线
+        void Advance(const float curvature, const float length, float *x, float *y, float *yaw)
+        {
+            if (curvature == 0.0f)
+            {
+                *x += length * cosf(*yaw);
+                *y += length * sinf(*yaw);
+                return;
+            }
+            const float end_yaw = *yaw + curvature * length;
+            *x += (sinf(end_yaw) - sinf(*yaw)) / curvature;
+            *y += (cosf(*yaw) - cosf(end_yaw)) / curvature;
+            *yaw = end_yaw;
+        }
+    }
+
+    GeometricPlanner::GeometricPlanner(const GeometricPlannerConfig &config, const CollisionChecker *checker)
+        : m_config(config), m_checker(checker)
+    {
+    }
+
+    bool GeometricPlanner::Plan(const xviz::Pose &start, const xviz::Pose &goal, PlannedPath *path)
+    {
+        m_maneuvers.clear();
+        m_verified = 0;
+
+        // 目标坐标系: 原点为目标后轴中心, x 轴沿目标航向
+        const float gc = cosf(goal.yaw);
+        const float gs = sinf(goal.yaw);
+        const float dx = start.x - goal.x;
+        const float dy = start.y - goal.y;
+        m_start.position = Vec2f(gc * dx + gs * dy, gc * dy - gs * dx);
+        m_start.yaw = NormalizeAngle(start.yaw - goal.yaw);
+
+        const float min_radius = m_checker->Vehicle().MinTurningRadius();
+        std::vector<Segment> leads(1);
+        for (float length = m_config.leadStep; length <= m_config.maxLeadLength + 1e-3f;
+             length += m_config.leadStep)
+        {
+            for (const float sign : {1.0f, -1.0f})
+            {
+                Segment lead;
+                lead.length = sign * length;
+                leads.push_back(lead);
+                lead.curvature = 1.0f / min_radius;
+                leads.push_back(lead);
+                lead.curvature = -1.0f / min_radius;
+                leads.push_back(lead);
+            }
+        }
+
+        for (const Segment &lead : leads)
+        {
+            LocalPose pose = m_start;
+            float x = pose.position.x(), y = pose.position.y();
+            Advance(lead.curvature, lead.length, &x, &y, &pose.yaw);
+            pose.position = Vec2f(x, y);
+            pose.yaw = NormalizeAngle(pose.yaw);
+            for (const float scale : m_config.radiusScales)
+            {
+                AddSingleArc(lead, pose, scale * min_radius);
+                AddDoubleArc(lead, pose, scale * min_radius);
+            }
+        }
+
+        std::sort(m_maneuvers.begin(), m_maneuvers.end(),
+                  [](const Maneuver &a, const Maneuver &b) { return a.cost < b.cost; });
+        const int limit = std::min(static_cast<int>(m_maneuvers.size()), m_config.maxVerified);
+        for (int i = 0; i < limit; ++i)
+        {
+            if (Verify(m_maneuvers[i], start))
+            {
+                path->points = m_samples;
+                path->points.back().x = goal.x;
+                path->points.back().y = goal.y;
+                path->points.back().yaw = NormalizeAngle(goal.yaw);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void GeometricPlanner::AddSingleArc(const Segment &lead, const LocalPose &pose, const float radius)
+    {
+        // 直线 - 圆弧 - 直线: 圆心 (q, side * R) 与 x 轴相切, 到起点航向线的有向距离为 side * R
+        const float sin_yaw = sinf(pose.yaw);
+        const float cos_yaw = cosf(pose.yaw);
+        if (std::fabs(sin_yaw) < kMinSinYaw)
+        {
+            return;
+        }
+        const Vec2f &s = pose.position;
+        const LineSegment2f heading_line(s, s + Vec2f(cos_yaw, sin_yaw));
+        for (const float side : {1.0f, -1.0f})
+        {
+            const float q = s.x() + (cos_yaw * (side * radius - s.y()) - side * radius) / sin_yaw;
+            Vec2f tangent;
+            heading_line.GetPerpendicularFoot(Vec2f(q, side * radius), &tangent);
+
+            Maneuver maneuver;
+            maneuver.segments[0] = lead;
+            maneuver.segments[1].length = heading_line.ProjectOntoUnit(tangent);
+            maneuver.segments[2].curvature = side / radius;
+            maneuver.segments[2].length = NormalizeAngle(-pose.yaw) * side * radius;
+            maneuver.segments[3].length = -q;
+            maneuver.count = 4;
+            Commit(&maneuver);
+        }
+    }
+
+    void GeometricPlanner::AddDoubleArc(const Segment &lead, const LocalPose &pose, const float radius)
+    {
+        // 反向双圆弧: 第一段圆心在起点航向的 side 侧, 第二段圆心 (q, -side * R) 与 x 轴相切, 两圆外切
+        const Vec2f normal(-sinf(pose.yaw), cosf(pose.yaw));
+        for (const float side : {1.0f, -1.0f})
+        {
+            const Vec2f c1 = pose.position + normal * (side * radius);
+            const float c2y = -side * radius;
+            const float disc = 4.0f * radius * radius - Sqr(c1.y() - c2y);
+            if (disc < 0.0f)
+            {
+                continue;
+            }
+            for (const float root : {1.0f, -1.0f})
+            {
+                const Vec2f c2(c1.x() + root * std::sqrt(disc), c2y);
+                // 切换点处航向与圆心连线垂直
+                const float switch_yaw = (c2 - c1).Angle() + side * kHalfPi;
+
+                Maneuver maneuver;
+                maneuver.segments[0] = lead;
+                maneuver.segments[1].curvature = side / radius;
+                maneuver.segments[1].length = NormalizeAngle(switch_yaw - pose.yaw) * side * radius;
+                maneuver.segments[2].curvature = -side / radius;
+                maneuver.segments[2].length = -NormalizeAngle(-switch_yaw) * side * radius;
+                maneuver.segments[3].length = -c2.x();
+                maneuver.count = 4;
+                Commit(&maneuver);
+            }
+        }
+    }
+
+    void GeometricPlanner::Commit(Maneuver *maneuver)
+    {
+        float x = m_start.position.x(), y = m_start.position.y(), yaw = m_start.yaw;
+        int count = 0;
+        float length = 0.0f;
+        int switches = 0;
+        float last_sign = 0.0f;
+        for (int i = 0; i < maneuver->count; ++i)
+        {
+            const Segment seg = maneuver->segments[i];
+            if (std::fabs(seg.length) < kMinSegmentLength)
+            {
+                continue;
+            }
+            Advance(seg.curvature, seg.length, &x, &y, &yaw);
+            const float sign = seg.length > 0.0f ? 1.0f : -1.0f;
+            switches += (last_sign != 0.0f && sign != last_sign) ? 1 : 0;
+            last_sign = sign;
+            length += std::fabs(seg.length);
+            maneuver->segments[count++] = seg;
+        }
+        maneuver->count = count;
+
+        if (count == 0 || length > m_config.maxLength || switches > m_config.maxGearSwitches)
+        {
+            return;
+        }
+        if (std::hypot(x, y) > kEndPositionTolerance || std::fabs(NormalizeAngle(yaw)) > kEndYawTolerance)
+        {
+            return;
+        }
+        maneuver->cost = length + m_config.gearSwitchPenalty * switches;
+        m_maneuvers.push_back(*maneuver);
+    }
+
+    bool GeometricPlanner::Verify(const Maneuver &maneuver, const xviz::Pose &start)
+    {
+        ++m_verified;
+        Sample(maneuver, start, &m_samples);
+        // 先按间隔 kCoarseStride 检测再补齐其余采样点, 碰撞的候选多在第一轮就被排除
+        const size_t n = m_samples.size();
+        m_order.clear();
+        for (size_t offset = 0; offset < kCoarseStride; ++offset)
+        {
+            for (size_t i = offset; i < n; i += kCoarseStride)
+            {
+                m_order.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        for (size_t first = 0; first < n; first += PackF8::kLanes)
+        {
+            PackF8 x, y, c, s;
+            PackF8::Mask active;
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                const PathPoint &pt = m_samples[m_order[std::min(first + k, n - 1)]];
+                x[k] = pt.x;
+                y[k] = pt.y;
+                c[k] = cosf(pt.yaw);
+                s[k] = sinf(pt.yaw);
+                active.lanes[k] = first + k < n;
+            }
+            const PackF8::Mask free = m_checker->IsFree(x, y, c, s, active);
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                if (active.lanes[k] && !free.lanes[k])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void GeometricPlanner::Sample(const Maneuver &maneuver, const xviz::Pose &start,
+                                  std::vector<PathPoint> *points) const
+    {
+        points->clear();
+        float x = start.x, y = start.y, yaw = start.yaw;
+        PathPoint pt;
+        pt.x = x;
+        pt.y = y;
+        pt.yaw = NormalizeAngle(yaw);
+        pt.forward = maneuver.segments[0].length > 0.0f;
+        points->push_back(pt);
+        for (int i = 0; i < maneuver.count; ++i)
+        {
+            const Segment &seg = maneuver.segments[i];
+            const int n = std::max(1, static_cast<int>(std::ceil(std::fabs(seg.length) / m_config.sampleInterval)));
+            const float ds = seg.length / n;
+            for (int k = 0; k < n; ++k)
+            {
+                Advance(seg.curvature, ds, &x, &y, &yaw);
+                pt.x = x;
+                pt.y = y;
+                pt.yaw = NormalizeAngle(yaw);
+                pt.forward = seg.length > 0.0f;
+                points->push_back(pt);
+            }
+        }
+    }
+
+} // namespace auto_parking_planning
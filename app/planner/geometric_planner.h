@@ -0,0 +1,100 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-22 20:41:36
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-22 20:41:36
+ */
+
+#ifndef __GEOMETRIC_PLANNER_H__
+#define __GEOMETRIC_PLANNER_H__
+
+#include "collision_checker.h"
+#include "data_types.h"
+#include "math/vec2f.h"
+#include "planner_types.h"
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct GeometricPlannerConfig
+    {
+        /// 圆弧半径取最小转弯半径的这些倍数
+        std::vector<float> radiusScales = {1.0f, 1.15f, 1.3f, 1.6f, 2.0f};
+        /// 前导直线段的最大长度与步长, 前导圆弧按最小转弯半径取相同长度
+        float maxLeadLength = 3.0f;
+        float leadStep = 0.5f;
+        float sampleInterval = 0.1f;
+        float maxLength = 40.0f;
+        int maxGearSwitches = 3;
+        float gearSwitchPenalty = 4.0f;
+        /// 按代价升序最多做碰撞检测的候选数, 限制全部失败时的耗时
+        int maxVerified = 64;
+    };
+
+    /// @brief 解析式泊车: 在目标坐标系下解出 "前导段 + 单圆弧 + 入库直线" 与
+    /// "前导段 + 反向双圆弧 + 入库直线" 两类机动, 前导段为直线或最小半径圆弧,
+    /// 因此覆盖垂直库位常用的单圆弧和平行库位的两段、三段圆弧.
+    /// 候选按长度与换挡次数排序, 依次做碰撞检测, 第一条无碰撞的即为结果
+    class GeometricPlanner
+    {
+    public:
+        GeometricPlanner(const GeometricPlannerConfig &config, const CollisionChecker *checker);
+
+        /// @brief 找到无碰撞机动时写入 path 并返回 true, 否则交给搜索
+        bool Plan(const xviz::Pose &start, const xviz::Pose &goal, PlannedPath *path);
+
+        /// @brief 上次规划解出的候选数与做过碰撞检测的候选数
+        int Candidates() const { return static_cast<int>(m_maneuvers.size()); }
+
+        int Verified() const { return m_verified; }
+
+    private:
+        /// 曲率为 0 时是直线, 长度为负表示倒车
+        struct Segment
+        {
+            float curvature = 0.0f;
+            float length = 0.0f;
+        };
+
+        struct Maneuver
+        {
+            static constexpr int kMaxSegments = 5;
+
+            Segment segments[kMaxSegments];
+            int count = 0;
+            float cost = 0.0f;
+        };
+
+        /// @brief 目标坐标系下的位姿
+        struct LocalPose
+        {
+            Vec2f position;
+            float yaw = 0.0f;
+        };
+
+        void AddSingleArc(const Segment &lead, const LocalPose &pose, const float radius);
+
+        void AddDoubleArc(const Segment &lead, const LocalPose &pose, const float radius);
+
+        /// @brief 从起点积分整条机动, 终点确实落在目标上才计算代价并加入候选
+        void Commit(Maneuver *maneuver);
+
+        bool Verify(const Maneuver &maneuver, const xviz::Pose &start);
+
+        void Sample(const Maneuver &maneuver, const xviz::Pose &start, std::vector<PathPoint> *points) const;
+
+    private:
+        GeometricPlannerConfig m_config;
+        const CollisionChecker *m_checker;
+        LocalPose m_start;
+        std::vector<Maneuver> m_maneuvers;
+        std::vector<PathPoint> m_samples;
+        /// 碰撞检测的采样点顺序
+        std::vector<uint32_t> m_order;
+        int m_verified = 0;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __GEOMETRIC_PLANNER_H__ */
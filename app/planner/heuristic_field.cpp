@@ -0,0 +1,243 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-17 20:26:50
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-17 20:26:50
+ */
+#include "heuristic_field.h"
+#include "common/task_scheduler.h"
+#include "map/grid_map_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        /// 同一桶内待松弛栅格数超过该值才分给多个线程
+        constexpr size_t kParallelGrain = 4096;
+
+        constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+
+        constexpr float kSqrt2 = 1.41421356f;
+
+        /// 非负浮点原子取小, 成功降低时返回 true
+        bool AtomicMin(std::atomic<float> *target, const float value)
+        {
+            float current = target->load(std::memory_order_relaxed);
+            while (value < current)
+            {
+                if (target->compare_exchange_weak(current, value, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    HeuristicFieldService::HeuristicFieldService(const HeuristicFieldConfig &config) : m_config(config)
+    {
+        const int workers = config.workers > 0 ? config.workers : TaskScheduler::Instance().Concurrency();
+        m_workerOut.resize(std::max(1, workers));
+    }
+
+    const HeuristicField *HeuristicFieldService::Acquire(const CollisionChecker &checker, const float goal_x,
+                                                         const float goal_y)
+    {
+        const xviz::GridMap &map = checker.Map();
+        if (map.m_data == nullptr || GridCellCount(map) == 0)
+        {
+            return nullptr;
+        }
+        if (m_maskGeneration != checker.MapGeneration() || m_free.empty())
+        {
+            BuildMask(checker);
+        }
+
+        float gx, gy;
+        WorldToGrid(map, goal_x, goal_y, &gx, &gy);
+        const int cx = static_cast<int>(std::floor(gx / m_scale));
+        const int cy = static_cast<int>(std::floor(gy / m_scale));
+        if (cx < 0 || cy < 0 || cx >= m_width || cy >= m_height)
+        {
+            return nullptr;
+        }
+        const int goal_cell = cy * m_width + cx;
+
+        ++m_useCounter;
+        HeuristicField *victim = nullptr;
+        for (auto &field : m_cache)
+        {
+            if (field->m_generation == m_maskGeneration && field->m_goalCell == goal_cell)
+            {
+                ++m_hits;
+                field->m_lastUse = m_useCounter;
+                return field.get();
+            }
+            if (victim == nullptr || field->m_lastUse < victim->m_lastUse)
+            {
+                victim = field.get();
+            }
+        }
+
+        ++m_misses;
+        if (m_cache.size() < std::max<size_t>(1, m_config.cacheSize))
+        {
+            m_cache.emplace_back(new HeuristicField());
+            victim = m_cache.back().get();
+        }
+        victim->m_generation = m_maskGeneration;
+        victim->m_goalCell = goal_cell;
+        victim->m_lastUse = m_useCounter;
+        Propagate(goal_cell, victim);
+        return victim;
+    }
+
+    void HeuristicFieldService::BuildMask(const CollisionChecker &checker)
+    {
+        const xviz::GridMap &map = checker.Map();
+        const VehicleParam &vehicle = checker.Vehicle();
+        m_maskGeneration = checker.MapGeneration();
+        m_scale = std::max(1, static_cast<int>(std::lround(m_config.resolution / map.m_res)));
+        m_cellSize = m_scale * map.m_res;
+        m_width = (GridWidth(map) + m_scale - 1) / m_scale;
+        m_height = (GridHeight(map) + m_scale - 1) / m_scale;
+
+        // 任何无碰撞位姿下, 后轴中心到车身边界的距离不小于该值;
+        // 再减去粗栅格中心到栅格内任意点的距离, 保证掩码不会误删可行位置
+        const float body_clearance = std::min(0.5f * vehicle.width, vehicle.rearOverhang);
+        const float required = body_clearance - 0.7072f * m_cellSize;
+        const DistanceField &esdf = checker.Esdf();
+        m_free.assign(static_cast<size_t>(m_width) * m_height, 0);
+        for (int y = 0; y < m_height; ++y)
+        {
+            const int my = std::min(y * m_scale + m_scale / 2, GridHeight(map) - 1);
+            for (int x = 0; x < m_width; ++x)
+            {
+                const int mx = std::min(x * m_scale + m_scale / 2, GridWidth(map) - 1);
+                m_free[static_cast<size_t>(y) * m_width + x] = esdf.Distance(mx, my) > required ? 1 : 0;
+            }
+        }
+
+        const size_t cells = m_free.size();
+        if (cells > m_costSize)
+        {
+            m_cost.reset(new std::atomic<float>[cells]);
+            m_costSize = cells;
+        }
+    }
+
+    void HeuristicFieldService::RelaxRange(const std::vector<Relaxed> &frontier, const size_t begin,
+                                           const size_t end, std::vector<Relaxed> *out)
+    {
+        static const int kDx[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+        static const int kDy[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+        const float step[2] = {m_cellSize, kSqrt2 * m_cellSize};
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Relaxed &item = frontier[i];
+            // 已被更小代价覆盖的重复项
+            if (m_cost[item.cell].load(std::memory_order_relaxed) < item.cost)
+            {
+                continue;
+            }
+            const int x = static_cast<int>(item.cell % m_width);
+            const int y = static_cast<int>(item.cell / m_width);
+            for (int k = 0; k < 8; ++k)
+            {
+                const int nx = x + kDx[k];
+                const int ny = y + kDy[k];
+                if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height)
+                {
+                    continue;
+                }
+                const uint32_t neighbor = static_cast<uint32_t>(ny * m_width + nx);
+                if (!m_free[neighbor])
+                {
+                    continue;
+                }
+                const float cost = item.cost + step[k >> 2];
+                if (AtomicMin(&m_cost[neighbor], cost))
+                {
+                    out->push_back({neighbor, cost});
+                }
+            }
+        }
+    }
+
+    void HeuristicFieldService::Propagate(const int goal_cell, HeuristicField *field)
+    {
+        const size_t cells = m_free.size();
+        for (size_t i = 0; i < cells; ++i)
+        {
+            m_cost[i].store(kUnreachable, std::memory_order_relaxed);
+        }
+        for (auto &bucket : m_buckets)
+        {
+            bucket.clear();
+        }
+
+        // 目标栅格本身可能因掩码保守而不可通行, 仍从它出发
+        m_cost[goal_cell].store(0.0f, std::memory_order_relaxed);
+        if (m_buckets.empty())
+        {
+            m_buckets.resize(1);
+        }
+        m_buckets[0].push_back({static_cast<uint32_t>(goal_cell), 0.0f});
+
+        // 边长不小于 Δ, 处理桶 b 时产生的代价都落在之后的桶里, 因此每个桶只需处理一次
+        const float inv_delta = 1.0f / m_cellSize;
+        std::vector<Relaxed> frontier;
+        for (size_t b = 0; b < m_buckets.size(); ++b)
+        {
+            frontier.swap(m_buckets[b]);
+            m_buckets[b].clear();
+            if (frontier.empty())
+            {
+                continue;
+            }
+
+            const size_t workers = std::min(m_workerOut.size(), (frontier.size() + kParallelGrain - 1) / kParallelGrain);
+            for (size_t w = 0; w < workers; ++w)
+            {
+                m_workerOut[w].clear();
+            }
+            if (workers <= 1)
+            {
+                RelaxRange(frontier, 0, frontier.size(), &m_workerOut[0]);
+            }
+            else
+            {
+                const size_t chunk = (frontier.size() + workers - 1) / workers;
+                TaskScheduler::Instance().ParallelFor(
+                    0, frontier.size(), chunk, [this, &frontier, chunk](const size_t begin, const size_t end) {
+                        RelaxRange(frontier, begin, end, &m_workerOut[begin / chunk]);
+                    });
+            }
+
+            for (size_t w = 0; w < std::max<size_t>(1, workers); ++w)
+            {
+                for (const Relaxed &item : m_workerOut[w])
+                {
+                    const size_t target = std::max(b + 1, static_cast<size_t>(item.cost * inv_delta));
+                    if (target >= m_buckets.size())
+                    {
+                        m_buckets.resize(target + 1);
+                    }
+                    m_buckets[target].push_back(item);
+                }
+            }
+        }
+
+        field->m_width = m_width;
+        field->m_height = m_height;
+        field->m_invScale = 1.0f / m_scale;
+        field->m_data.resize(cells);
+        for (size_t i = 0; i < cells; ++i)
+        {
+            field->m_data[i] = m_cost[i].load(std::memory_order_relaxed);
+        }
+    }
+
+} // namespace auto_parking_planning
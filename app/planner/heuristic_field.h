@@ -0,0 +1,122 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-17 19:42:15
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-17 19:42:15
+ */
+
+#ifndef __HEURISTIC_FIELD_H__
+#define __HEURISTIC_FIELD_H__
+
+#include "collision_checker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct HeuristicFieldConfig
+    {
+        /// 粗栅格边长, 取地图分辨率的整数倍
+        float resolution = 0.3f;
+        /// 同一桶内最多分成的并行块数, 0 表示使用共享调度器的并行度
+        int workers = 0;
+        /// 缓存的目标数
+        size_t cacheSize = 4;
+    };
+
+    /// @brief 以目标为源、考虑障碍物的二维完整约束代价场, 单位米.
+    /// 数据为行优先的连续 float 数组, 不可达为无穷大
+    class HeuristicField
+    {
+    public:
+        /// @brief 地图栅格坐标(浮点)处的代价
+        float Lookup(const float gx, const float gy) const
+        {
+            const int cx = static_cast<int>(gx * m_invScale);
+            const int cy = static_cast<int>(gy * m_invScale);
+            if (gx < 0.0f || gy < 0.0f || cx >= m_width || cy >= m_height)
+            {
+                return std::numeric_limits<float>::infinity();
+            }
+            return m_data[static_cast<size_t>(cy) * m_width + cx];
+        }
+
+        int Width() const { return m_width; }
+
+        int Height() const { return m_height; }
+
+        const float *Data() const { return m_data.data(); }
+
+    private:
+        friend class HeuristicFieldService;
+
+        int m_width = 0;
+        int m_height = 0;
+        /// 地图栅格到粗栅格的缩放
+        float m_invScale = 1.0f;
+        std::vector<float> m_data;
+
+        /// 缓存键
+        uint64_t m_generation = 0;
+        int m_goalCell = -1;
+        uint64_t m_lastUse = 0;
+    };
+
+    /// @brief 代价场服务. 按 (地图代数, 目标粗栅格) 缓存代价场;
+    /// 同一地图下换目标时复用可通行掩码与已分配的缓冲, 只重新传播代价.
+    /// 传播采用按桶推进的波前(Δ 取直行边长的 delta-stepping), 同一桶内的松弛可多线程并行
+    class HeuristicFieldService
+    {
+    public:
+        explicit HeuristicFieldService(const HeuristicFieldConfig &config = HeuristicFieldConfig());
+
+        /// @brief 取得 checker 当前地图下以 (goal_x, goal_y) 为目标的代价场
+        const HeuristicField *Acquire(const CollisionChecker &checker, const float goal_x, const float goal_y);
+
+        uint64_t Hits() const { return m_hits; }
+
+        uint64_t Misses() const { return m_misses; }
+
+    private:
+        struct Relaxed
+        {
+            uint32_t cell;
+            float cost;
+        };
+
+        void BuildMask(const CollisionChecker &checker);
+
+        void Propagate(const int goal_cell, HeuristicField *field);
+
+        void RelaxRange(const std::vector<Relaxed> &frontier, const size_t begin, const size_t end,
+                        std::vector<Relaxed> *out);
+
+    private:
+        HeuristicFieldConfig m_config;
+        std::vector<std::unique_ptr<HeuristicField>> m_cache;
+        uint64_t m_useCounter = 0;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+
+        /// 当前地图的粗栅格与可通行掩码
+        uint64_t m_maskGeneration = 0;
+        int m_width = 0;
+        int m_height = 0;
+        int m_scale = 1;
+        float m_cellSize = 0.0f;
+        std::vector<uint8_t> m_free;
+
+        /// 传播用缓冲, 跨目标复用
+        std::unique_ptr<std::atomic<float>[]> m_cost;
+        size_t m_costSize = 0;
+        std::vector<std::vector<Relaxed>> m_buckets;
+        std::vector<std::vector<Relaxed>> m_workerOut;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __HEURISTIC_FIELD_H__ */
@@ -0,0 +1,461 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-12 21:40:18
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-12 21:40:18
+ */
+#include "hybrid_a_star.h"
+#include "common/profiler.h"
+#include "map/grid_map_utils.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kStraightCurvature = 1e-6f;
+        /// 八邻域栅格距离最多比欧氏距离长 8.24%, 乘以该系数保证代价场不高估
+        constexpr float kOctileToEuclidean = 0.9239f;
+    }
+
+    HybridAStar::HybridAStar(const HybridAStarConfig &config, const CollisionChecker *checker)
+        : m_config(config),
+          m_checker(checker),
+          m_rs(checker->Vehicle().MinTurningRadius()),
+          m_rollout(checker),
+          m_budget(config.maxSearchMemory),
+          m_nodes(&m_budget),
+          m_points(&m_budget),
+          m_fieldService(config.holonomic),
+          m_states(&m_budget),
+          m_open(config.openListResolution)
+    {
+        // 间隔为 0 时按每次扩展处理, 避免取模除零
+        m_config.analyticExpansionInterval = std::max(1, config.analyticExpansionInterval);
+        m_config.cancelCheckInterval = std::max(1u, config.cancelCheckInterval);
+        const int n = std::max(1, config.steerSamples);
+        const float max_steer = checker->Vehicle().maxSteer;
+        for (int i = 0; i < n; ++i)
+        {
+            m_steers.push_back(n == 1 ? 0.0f : -max_steer + 2.0f * max_steer * i / (n - 1));
+        }
+        m_rolloutSteps = std::max(1, static_cast<int>(std::ceil(config.stepSize / config.sampleInterval)));
+        for (int dir = 0; dir < 2; ++dir)
+        {
+            for (const float steer : m_steers)
+            {
+                RolloutCandidate cand;
+                cand.curvature = tanf(steer) / checker->Vehicle().wheelBase;
+                cand.ds = (dir == 0 ? 1.0f : -1.0f) * config.stepSize / m_rolloutSteps;
+                m_candidates.push_back(cand);
+            }
+        }
+        if (config.useLattice && DefaultLattice::Matches(n, config.stepSize, config.sampleInterval,
+                                                         checker->Vehicle().wheelBase, max_steer))
+        {
+            m_lattice = DefaultLattice::View();
+        }
+        if (!config.rsTablePath.empty())
+        {
+            m_rsTable.Load(config.rsTablePath, m_rs.TurningRadius());
+        }
+    }
+
+    uint64_t HybridAStar::StateKey(const float x, const float y, const float yaw) const
+    {
+        float gx, gy;
+        WorldToGrid(m_checker->Map(), x, y, &gx, &gy);
+        const float scale = m_checker->Map().m_res / m_config.xyResolution;
+        const uint64_t xi = static_cast<uint64_t>(static_cast<int64_t>(std::floor(gx * scale))) & 0xFFFFFF;
+        const uint64_t yi = static_cast<uint64_t>(static_cast<int64_t>(std::floor(gy * scale))) & 0xFFFFFF;
+        const float bin_size = 2.0f * static_cast<float>(M_PI) / m_config.headingBins;
+        const uint64_t ti = static_cast<uint64_t>(WrapAngle(yaw) / bin_size) % m_config.headingBins;
+        return (xi << 40) | (yi << 16) | ti;
+    }
+
+    float HybridAStar::Heuristic(const float x, const float y, const float yaw) const
+    {
+        float rs;
+        if (!m_rsTable.Loaded() || !m_rsTable.Lookup(x, y, yaw, m_goal.x, m_goal.y, m_goal.yaw, &rs))
+        {
+            rs = m_rs.Distance(x, y, yaw, m_goal.x, m_goal.y, m_goal.yaw);
+        }
+        if (m_field == nullptr)
+        {
+            return rs;
+        }
+        float gx, gy;
+        WorldToGrid(m_checker->Map(), x, y, &gx, &gy);
+        // 代价场在粗栅格中心采样, 扣除起终点各半个栅格对角线
+        const float cell_diagonal = 1.4143f * m_config.holonomic.resolution;
+        const float holonomic = kOctileToEuclidean * m_field->Lookup(gx, gy) - cell_diagonal;
+        return std::max(rs, holonomic);
+    }
+
+    bool HybridAStar::Expand(const SearchNode &node, const int steer_index, const bool forward,
+                             std::vector<PathPoint> *trace) const
+    {
+        const float curvature = tanf(m_steers[steer_index]) / m_checker->Vehicle().wheelBase;
+        const int n = std::max(1, static_cast<int>(std::ceil(m_config.stepSize / m_config.sampleInterval)));
+        const float ds = (forward ? 1.0f : -1.0f) * m_config.stepSize / n;
+
+        trace->clear();
+        float x = node.x, y = node.y, yaw = node.yaw;
+        for (int i = 0; i < n; ++i)
+        {
+            if (std::fabs(curvature) < kStraightCurvature)
+            {
+                x += ds * cosf(yaw);
+                y += ds * sinf(yaw);
+            }
+            else
+            {
+                const float next_yaw = yaw + curvature * ds;
+                x += (sinf(next_yaw) - sinf(yaw)) / curvature;
+                y += (cosf(yaw) - cosf(next_yaw)) / curvature;
+                yaw = next_yaw;
+            }
+            yaw = NormalizeAngle(yaw);
+            if (!m_checker->IsFree(x, y, yaw))
+            {
+                return false;
+            }
+            PathPoint pt;
+            pt.x = x;
+            pt.y = y;
+            pt.yaw = yaw;
+            pt.forward = forward;
+            trace->push_back(pt);
+        }
+        return true;
+    }
+
+    void HybridAStar::RolloutChildren(const SearchNode &node)
+    {
+        if (m_lattice.samples != nullptr)
+        {
+            m_rollout.Run(m_lattice, node.x, node.y, node.yaw);
+            return;
+        }
+        for (RolloutCandidate &cand : m_candidates)
+        {
+            cand.x = node.x;
+            cand.y = node.y;
+            cand.yaw = node.yaw;
+        }
+        m_rollout.Run(m_candidates, m_rolloutSteps);
+    }
+
+    bool HybridAStar::TryAnalyticExpansion(const SearchNode &node, std::vector<PathPoint> *trace) const
+    {
+        const ReedsSheppPath rs_path =
+            m_rs.ShortestPath(node.x, node.y, node.yaw, m_goal.x, m_goal.y, m_goal.yaw);
+        trace->clear();
+        m_rs.Sample(node.x, node.y, node.yaw, rs_path, m_config.sampleInterval, trace);
+        for (const auto &pt : *trace)
+        {
+            if (!m_checker->IsFree(pt.x, pt.y, pt.yaw))
+            {
+                return false;
+            }
+        }
+        return !trace->empty();
+    }
+
+    bool HybridAStar::IsGoalReached(const SearchNode &node) const
+    {
+        return hypotf(node.x - m_goal.x, node.y - m_goal.y) <= m_config.goalTolerancePosition &&
+               std::fabs(AngleDiff(node.yaw, m_goal.yaw)) <= m_config.goalToleranceYaw;
+    }
+
+    bool HybridAStar::SetTrace(SearchNode *node, const std::vector<PathPoint> &trace)
+    {
+        node->traceBegin = kInvalidIndex;
+        node->traceSize = 0;
+        if (trace.empty())
+        {
+            return true;
+        }
+        const uint32_t begin = m_points.Allocate(static_cast<uint32_t>(trace.size()));
+        if (begin == kInvalidIndex)
+        {
+            return false;
+        }
+        std::copy(trace.begin(), trace.end(), &m_points[begin]);
+        node->traceBegin = begin;
+        node->traceSize = static_cast<uint16_t>(trace.size());
+        return true;
+    }
+
+    void HybridAStar::BuildPath(const uint32_t node, const std::vector<PathPoint> &tail, PlannedPath *path)
+    {
+        path->points.clear();
+        m_chain.clear();
+        for (uint32_t n = node; n != kInvalidIndex; n = m_nodes[n].parent)
+        {
+            m_chain.push_back(n);
+        }
+        std::reverse(m_chain.begin(), m_chain.end());
+
+        const SearchNode &root = m_nodes[m_chain.front()];
+        PathPoint start;
+        start.x = root.x;
+        start.y = root.y;
+        start.yaw = root.yaw;
+        path->points.push_back(start);
+        for (size_t i = 1; i < m_chain.size(); ++i)
+        {
+            const SearchNode &n = m_nodes[m_chain[i]];
+            const PathPoint *trace = &m_points[n.traceBegin];
+            path->points.insert(path->points.end(), trace, trace + n.traceSize);
+        }
+        path->points.insert(path->points.end(), tail.begin(), tail.end());
+        // 起点方向与第一段运动一致
+        if (path->points.size() > 1)
+        {
+            path->points.front().forward = path->points[1].forward;
+        }
+    }
+
+    uint32_t *HybridAStar::StateSlot(const uint64_t key)
+    {
+        if (m_recorder != nullptr)
+        {
+            m_recorder->RecordState(key);
+        }
+        return m_states.Slot(key);
+    }
+
+    void HybridAStar::PushOpen(const uint32_t node, const float f)
+    {
+        if (m_recorder != nullptr)
+        {
+            m_recorder->RecordOpen(SearchRecorder::OpenOp::PUSH, node, f);
+        }
+        m_open.Push(node, f);
+    }
+
+    void HybridAStar::UpdateOpen(const uint32_t node, const float f)
+    {
+        if (m_recorder != nullptr)
+        {
+            m_recorder->RecordOpen(SearchRecorder::OpenOp::UPDATE, node, f);
+        }
+        m_open.Update(node, f);
+    }
+
+    uint32_t HybridAStar::PopOpen()
+    {
+        const uint32_t node = m_open.Pop();
+        if (m_recorder != nullptr)
+        {
+            m_recorder->RecordOpen(SearchRecorder::OpenOp::POP, node, 0.0f);
+        }
+        return node;
+    }
+
+    bool HybridAStar::Reset()
+    {
+        m_budget.Reset();
+        m_nodes.Reset();
+        m_points.Reset();
+        m_expansions = 0;
+
+        m_open.Clear();
+        if (m_recorder != nullptr)
+        {
+            m_recorder->Clear();
+        }
+
+        // 状态表按地图离散状态数预分配, 搜索通常只访问其中一小部分; 初始容量不超过内存预算的 1/4,
+        // 大地图上不够时在搜索中扩容, 扩容同样计入预算
+        const xviz::GridMap &map = m_checker->Map();
+        const float scale = map.m_res / m_config.xyResolution;
+        const size_t states = static_cast<size_t>(std::ceil(GridWidth(map) * scale)) *
+                              static_cast<size_t>(std::ceil(GridHeight(map) * scale)) * m_config.headingBins;
+        const size_t max_states = m_config.maxSearchMemory / (16 * StateTable::kSlotBytes);
+        return m_states.Reset(std::min(states / 8, max_states));
+    }
+
+    PlanStatus HybridAStar::Plan(const xviz::Pose &start, const xviz::Pose &goal, PlannedPath *path,
+                                 const CancelToken &cancel, const std::chrono::steady_clock::time_point &deadline)
+    {
+        if (!Reset())
+        {
+            return PlanStatus::MEMORY_LIMIT;
+        }
+        m_goal = goal;
+        if (!m_checker->IsFree(start.x, start.y, start.yaw))
+        {
+            return PlanStatus::INVALID_START;
+        }
+        if (!m_checker->IsFree(goal.x, goal.y, goal.yaw))
+        {
+            return PlanStatus::INVALID_GOAL;
+        }
+
+        m_field = m_config.useHolonomicHeuristic ? m_fieldService.Acquire(*m_checker, goal.x, goal.y) : nullptr;
+        const float root_h = Heuristic(start.x, start.y, NormalizeAngle(start.yaw));
+        if (std::isinf(root_h))
+        {
+            // 代价场中起点与目标不连通
+            return PlanStatus::NO_PATH;
+        }
+
+        const uint32_t root_index = m_nodes.Allocate();
+        if (root_index == kInvalidIndex)
+        {
+            return PlanStatus::MEMORY_LIMIT;
+        }
+        SearchNode &root = m_nodes[root_index];
+        root = SearchNode();
+        root.x = start.x;
+        root.y = start.y;
+        root.yaw = NormalizeAngle(start.yaw);
+        root.key = StateKey(root.x, root.y, root.yaw);
+        root.f = m_config.heuristicWeight * root_h;
+        uint32_t *root_slot = StateSlot(root.key);
+        if (root_slot == nullptr)
+        {
+            return PlanStatus::MEMORY_LIMIT;
+        }
+        *root_slot = root_index;
+        PushOpen(root_index, root.f);
+
+        while (!m_open.Empty())
+        {
+            const uint32_t node_index = PopOpen();
+            // 池内元素地址在本次规划中不变, 分配新节点后引用仍然有效
+            SearchNode &node = m_nodes[node_index];
+            node.closed = true;
+            if (++m_expansions > m_config.maxExpansions)
+            {
+                break;
+            }
+            if (m_expansions % m_config.cancelCheckInterval == 0)
+            {
+                if (cancel.IsCancelled())
+                {
+                    return PlanStatus::CANCELLED;
+                }
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return PlanStatus::TIMEOUT;
+                }
+            }
+            APP_PROFILE_COUNT(ProfileChannel::EXPANSIONS, 1);
+
+            if (IsGoalReached(node))
+            {
+                m_trace.clear();
+                BuildPath(node_index, m_trace, path);
+                return PlanStatus::SUCCESS;
+            }
+            const float h = node.f - node.g;
+            if ((h < m_config.analyticExpansionRange * m_config.heuristicWeight ||
+                 m_expansions % m_config.analyticExpansionInterval == 0) &&
+                TryAnalyticExpansion(node, &m_trace))
+            {
+                BuildPath(node_index, m_trace, path);
+                return PlanStatus::SUCCESS;
+            }
+
+            if (m_config.batchRollout)
+            {
+                RolloutChildren(node);
+            }
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                const bool forward = dir == 0;
+                for (int s = 0; s < static_cast<int>(m_steers.size()); ++s)
+                {
+                    if (m_config.batchRollout)
+                    {
+                        const size_t candidate = dir * m_steers.size() + s;
+                        if (!m_rollout.Valid(candidate))
+                        {
+                            continue;
+                        }
+                        m_rollout.Trace(candidate, &m_trace);
+                    }
+                    else if (!Expand(node, s, forward, &m_trace))
+                    {
+                        continue;
+                    }
+                    const PathPoint &end = m_trace.back();
+                    const uint64_t key = StateKey(end.x, end.y, end.yaw);
+                    if (key == node.key)
+                    {
+                        continue;
+                    }
+
+                    float cost = m_config.stepSize * (forward ? 1.0f : m_config.reversePenalty);
+                    cost += m_config.steerPenalty * std::fabs(m_steers[s]) * m_config.stepSize;
+                    if (node.parent != kInvalidIndex)
+                    {
+                        cost += m_config.steerChangePenalty * std::fabs(m_steers[s] - m_steers[node.steer]);
+                        if (node.forward != forward)
+                        {
+                            cost += m_config.gearSwitchPenalty;
+                        }
+                    }
+                    const float g = node.g + cost;
+
+                    // 以下不会再插入状态表, 引用在本次循环内有效
+                    uint32_t *slot = StateSlot(key);
+                    if (slot == nullptr)
+                    {
+                        return PlanStatus::MEMORY_LIMIT;
+                    }
+                    uint32_t &state = *slot;
+                    if (state != kInvalidIndex && (m_nodes[state].closed || g >= m_nodes[state].g))
+                    {
+                        continue;
+                    }
+                    // 未能插入时状态表中留下的是 kInvalidIndex, 与不存在等价
+                    const float child_h = Heuristic(end.x, end.y, end.yaw);
+                    if (std::isinf(child_h))
+                    {
+                        continue;
+                    }
+
+                    // 已在开放列表中的状态直接改写节点并降低其代价, 不产生重复项
+                    const bool is_new = state == kInvalidIndex;
+                    const uint32_t child_index = is_new ? m_nodes.Allocate() : state;
+                    if (child_index == kInvalidIndex)
+                    {
+                        return PlanStatus::MEMORY_LIMIT;
+                    }
+                    SearchNode &child = m_nodes[child_index];
+                    child = SearchNode();
+                    if (!SetTrace(&child, m_trace))
+                    {
+                        return PlanStatus::MEMORY_LIMIT;
+                    }
+                    child.x = end.x;
+                    child.y = end.y;
+                    child.yaw = end.yaw;
+                    child.g = g;
+                    child.f = g + m_config.heuristicWeight * child_h;
+                    child.parent = node_index;
+                    child.key = key;
+                    child.steer = static_cast<int8_t>(s);
+                    child.forward = forward;
+                    if (is_new)
+                    {
+                        state = child_index;
+                        PushOpen(child_index, child.f);
+                    }
+                    else
+                    {
+                        UpdateOpen(child_index, child.f);
+                    }
+                }
+            }
+        }
+        return PlanStatus::NO_PATH;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,172 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-12 21:06:33
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-12 21:06:33
+ */
+
+#ifndef __HYBRID_A_STAR_H__
+#define __HYBRID_A_STAR_H__
+
+#include "batch_rollout.h"
+#include "bucket_queue.h"
+#include "collision_checker.h"
+#include "common/cancel_token.h"
+#include "common/index_pool.h"
+#include "heuristic_field.h"
+#include "planner_types.h"
+#include "reeds_shepp.h"
+#include "rs_table.h"
+#include "search_recorder.h"
+#include "state_table.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct HybridAStarConfig
+    {
+        float xyResolution = 0.3f;
+        int headingBins = 72;
+        /// 单次扩展的弧长与采样间隔
+        float stepSize = 0.9f;
+        float sampleInterval = 0.15f;
+        /// 方向盘离散数, 取奇数以包含直行
+        int steerSamples = 5;
+        /// 子节点以批量积分生成, 否则逐条标量积分
+        bool batchRollout = true;
+        /// 参数与编译期基元表一致时以查表代替批量积分
+        bool useLattice = true;
+        float reversePenalty = 1.5f;
+        float gearSwitchPenalty = 4.0f;
+        float steerPenalty = 0.2f;
+        float steerChangePenalty = 0.3f;
+        float heuristicWeight = 1.0f;
+        /// 启发值取 Reeds-Shepp 距离与考虑障碍物的二维代价场中的较大者
+        bool useHolonomicHeuristic = true;
+        HeuristicFieldConfig holonomic;
+        /// 离线生成的 Reeds-Shepp 代价表, 为空或加载失败时解析计算
+        std::string rsTablePath;
+        /// 距目标小于该距离时每次扩展都尝试 Reeds-Shepp 解析连接, 否则按间隔尝试; 间隔不大于 0 时视为 1
+        float analyticExpansionRange = 12.0f;
+        int analyticExpansionInterval = 8;
+        float goalTolerancePosition = 0.15f;
+        float goalToleranceYaw = 0.05f;
+        uint32_t maxExpansions = 200000;
+        /// 开放列表代价量化精度
+        float openListResolution = 0.02f;
+        /// 单次规划节点与轨迹点的内存上限
+        size_t maxSearchMemory = 64u << 20;
+        /// 每扩展该数量的节点检查一次取消标记与截止时间, 0 视为每次扩展都检查
+        uint32_t cancelCheckInterval = 64;
+    };
+
+    class HybridAStar
+    {
+    public:
+        HybridAStar(const HybridAStarConfig &config, const CollisionChecker *checker);
+
+        /// @brief 搜索从 start 到 goal 的路径, 地图由 checker 提供.
+        /// cancel 被取消后在下一个检查间隔内返回 CANCELLED, 超过 deadline 时同样在检查间隔内返回 TIMEOUT
+        PlanStatus Plan(const xviz::Pose &start, const xviz::Pose &goal, PlannedPath *path,
+                        const CancelToken &cancel = CancelToken(),
+                        const std::chrono::steady_clock::time_point &deadline =
+                            std::chrono::steady_clock::time_point::max());
+
+        /// @brief 启发权重, 限时规划在两次搜索之间调整
+        void SetHeuristicWeight(const float weight) { m_config.heuristicWeight = weight; }
+
+        float HeuristicWeight() const { return m_config.heuristicWeight; }
+
+        uint32_t Expansions() const { return m_expansions; }
+
+        /// @brief 上一次规划占用的节点池内存
+        size_t MemoryUsed() const { return m_budget.Used(); }
+
+        bool RsTableLoaded() const { return m_rsTable.Loaded(); }
+
+        /// @brief 设置后每次规划都会记录容器访问序列, 仅用于基准测试
+        void SetRecorder(SearchRecorder *recorder) { m_recorder = recorder; }
+
+    private:
+        struct SearchNode
+        {
+            float x = 0.0f;
+            float y = 0.0f;
+            float yaw = 0.0f;
+            float g = 0.0f;
+            float f = 0.0f;
+            uint32_t parent = kInvalidIndex;
+            /// 父节点到本节点的采样点在 m_points 中的位置, 不含父节点位姿
+            uint32_t traceBegin = kInvalidIndex;
+            uint64_t key = 0;
+            uint16_t traceSize = 0;
+            int8_t steer = 0;
+            bool forward = true;
+            bool closed = false;
+        };
+
+        uint64_t StateKey(const float x, const float y, const float yaw) const;
+
+        float Heuristic(const float x, const float y, const float yaw) const;
+
+        bool Expand(const SearchNode &node, const int steer_index, const bool forward,
+                    std::vector<PathPoint> *trace) const;
+
+        /// @brief 批量积分节点的全部子节点, 候选下标为 方向 * 方向盘数 + 方向盘下标
+        void RolloutChildren(const SearchNode &node);
+
+        bool TryAnalyticExpansion(const SearchNode &node, std::vector<PathPoint> *trace) const;
+
+        bool IsGoalReached(const SearchNode &node) const;
+
+        /// @brief 把轨迹保存到点池, 超出内存预算时返回 false
+        bool SetTrace(SearchNode *node, const std::vector<PathPoint> &trace);
+
+        void BuildPath(const uint32_t node, const std::vector<PathPoint> &tail, PlannedPath *path);
+
+        /// @brief 状态表与开放列表操作, 开启记录时同时记下访问
+        uint32_t *StateSlot(const uint64_t key);
+
+        void PushOpen(const uint32_t node, const float f);
+
+        void UpdateOpen(const uint32_t node, const float f);
+
+        uint32_t PopOpen();
+
+        /// @brief 复位搜索容器, 状态表超出内存预算时返回 false
+        bool Reset();
+
+    private:
+        HybridAStarConfig m_config;
+        const CollisionChecker *m_checker;
+        ReedsShepp m_rs;
+        ReedsSheppTable m_rsTable;
+        std::vector<float> m_steers;
+        BatchRollout m_rollout;
+        std::vector<RolloutCandidate> m_candidates;
+        int m_rolloutSteps = 1;
+        /// 参数与编译期基元表不一致时为空
+        LatticeView m_lattice;
+        xviz::Pose m_goal;
+        uint32_t m_expansions = 0;
+
+        MemoryBudget m_budget;
+        IndexPool<SearchNode> m_nodes;
+        IndexPool<PathPoint> m_points;
+        HeuristicFieldService m_fieldService;
+        const HeuristicField *m_field = nullptr;
+        StateTable m_states;
+        BucketQueue m_open;
+        SearchRecorder *m_recorder = nullptr;
+        /// 扩展与回溯用的临时缓冲, 跨规划复用
+        std::vector<PathPoint> m_trace;
+        std::vector<uint32_t> m_chain;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __HYBRID_A_STAR_H__ */
@@ -0,0 +1,211 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-24 20:48:19
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-24 20:48:19
+ */
+#include "path_shortcutter.h"
+#include "common/task_scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace auto_parking_planning
+{
+    PathShortcutter::PathShortcutter(const PathShortcutConfig &config, const CollisionChecker *checker)
+        : m_config(config), m_checker(checker), m_rs(checker->Vehicle().MinTurningRadius())
+    {
+    }
+
+    int PathShortcutter::Shortcut(PlannedPath *path, const std::chrono::steady_clock::time_point &deadline)
+    {
+        std::vector<PathPoint> &points = path->points;
+        const int n = static_cast<int>(points.size());
+        const int min_span = std::max(2, m_config.minSpan);
+        if (n <= min_span)
+        {
+            return 0;
+        }
+
+        m_prefixLength.assign(n, 0.0f);
+        m_prefixSwitches.assign(n, 0);
+        for (int k = 1; k < n; ++k)
+        {
+            const float length = hypotf(points[k].x - points[k - 1].x, points[k].y - points[k - 1].y);
+            m_prefixLength[k] = m_prefixLength[k - 1] + length * (points[k].forward ? 1.0f : m_config.reversePenalty);
+            m_prefixSwitches[k] = m_prefixSwitches[k - 1] + (points[k].forward != points[k - 1].forward ? 1 : 0);
+        }
+
+        // 点对在调用线程上按种子依次生成, 与并行执行的顺序无关
+        std::mt19937 rng(m_config.seed);
+        m_candidates.assign(std::max(0, m_config.candidates), Candidate());
+        for (Candidate &cand : m_candidates)
+        {
+            const int begin = std::uniform_int_distribution<int>(0, n - 1 - min_span)(rng);
+            const int max_span = std::max(min_span, std::min(m_config.maxSpan, n - 1 - begin));
+            cand.begin = static_cast<uint32_t>(begin);
+            cand.end = static_cast<uint32_t>(begin + std::uniform_int_distribution<int>(min_span, max_span)(rng));
+        }
+
+        TaskScheduler::Instance().ParallelFor(
+            0, m_candidates.size(), static_cast<size_t>(std::max(1, m_config.grain)),
+            [this, &points, &deadline](const size_t begin, const size_t end) {
+                std::vector<PathPoint> samples;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    // 到期后剩余候选保持无效
+                    if (std::chrono::steady_clock::now() >= deadline)
+                    {
+                        break;
+                    }
+                    Evaluate(points, &m_candidates[i], &samples);
+                }
+            });
+
+        uint32_t checks = 0;
+        std::vector<uint32_t> order;
+        for (uint32_t i = 0; i < m_candidates.size(); ++i)
+        {
+            checks += m_candidates[i].checks;
+            if (m_candidates[i].valid)
+            {
+                order.push_back(i);
+            }
+        }
+        m_checker->AddCheckCount(checks);
+
+        // 按代价下降量从大到小选取, 区间只允许在端点处相接
+        std::stable_sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) {
+            return m_candidates[a].gain > m_candidates[b].gain;
+        });
+        std::vector<const Candidate *> chosen;
+        for (const uint32_t i : order)
+        {
+            const Candidate &cand = m_candidates[i];
+            const bool overlaps = std::any_of(chosen.begin(), chosen.end(), [&cand](const Candidate *other) {
+                return cand.begin < other->end && other->begin < cand.end;
+            });
+            if (!overlaps)
+            {
+                chosen.push_back(&cand);
+            }
+        }
+        if (chosen.empty())
+        {
+            return 0;
+        }
+
+        std::sort(chosen.begin(), chosen.end(),
+                  [](const Candidate *a, const Candidate *b) { return a->begin < b->begin; });
+        m_output.clear();
+        uint32_t next = 0;
+        std::vector<PathPoint> samples;
+        for (const Candidate *cand : chosen)
+        {
+            m_output.insert(m_output.end(), points.begin() + next, points.begin() + cand->begin + 1);
+            const PathPoint &from = points[cand->begin];
+            samples.clear();
+            m_rs.Sample(from.x, from.y, from.yaw, cand->curve, m_config.sampleInterval, &samples);
+            // 末点取原路径上的位姿, 消除采样累积误差
+            PathPoint last = points[cand->end];
+            last.forward = samples.back().forward;
+            samples.back() = last;
+            m_output.insert(m_output.end(), samples.begin(), samples.end());
+            next = cand->end + 1;
+        }
+        m_output.insert(m_output.end(), points.begin() + next, points.end());
+        points.swap(m_output);
+        if (points.size() > 1)
+        {
+            points.front().forward = points[1].forward;
+        }
+        return static_cast<int>(chosen.size());
+    }
+
+    void PathShortcutter::Evaluate(const std::vector<PathPoint> &points, Candidate *candidate,
+                                   std::vector<PathPoint> *samples) const
+    {
+        const PathPoint &from = points[candidate->begin];
+        const PathPoint &to = points[candidate->end];
+        candidate->curve = m_rs.ShortestPath(from.x, from.y, from.yaw, to.x, to.y, to.yaw);
+        if (!candidate->curve.Valid())
+        {
+            return;
+        }
+        // 曲线长度是替换后代价的下界, 不足以带来收益的不必采样
+        const float old_cost = SpanCost(points, candidate->begin, candidate->end);
+        if (static_cast<float>(candidate->curve.totalLength) * m_rs.TurningRadius() > old_cost - m_config.minGain)
+        {
+            return;
+        }
+        samples->clear();
+        m_rs.Sample(from.x, from.y, from.yaw, candidate->curve, m_config.sampleInterval, samples);
+        if (samples->empty())
+        {
+            return;
+        }
+        const float gain = old_cost - ReplacementCost(points, candidate->begin, candidate->end, *samples);
+        if (gain < m_config.minGain)
+        {
+            return;
+        }
+
+        const size_t count = samples->size();
+        for (size_t first = 0; first < count; first += PackF8::kLanes)
+        {
+            PackF8 x, y, c, s;
+            PackF8::Mask active;
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                const PathPoint &pt = (*samples)[std::min(first + k, count - 1)];
+                x[k] = pt.x;
+                y[k] = pt.y;
+                c[k] = cosf(pt.yaw);
+                s[k] = sinf(pt.yaw);
+                active.lanes[k] = first + k < count;
+                candidate->checks += active.lanes[k] ? 1 : 0;
+            }
+            const PackF8::Mask free = m_checker->IsFreeUncounted(x, y, c, s, active);
+            for (int k = 0; k < PackF8::kLanes; ++k)
+            {
+                if (active.lanes[k] && !free.lanes[k])
+                {
+                    return;
+                }
+            }
+        }
+        candidate->gain = gain;
+        candidate->valid = true;
+    }
+
+    float PathShortcutter::SpanCost(const std::vector<PathPoint> &points, const uint32_t begin,
+                                    const uint32_t end) const
+    {
+        const size_t last = std::min<size_t>(end + 1, points.size() - 1);
+        const uint32_t switches = m_prefixSwitches[last] - m_prefixSwitches[begin];
+        return m_prefixLength[end] - m_prefixLength[begin] + m_config.gearSwitchPenalty * switches;
+    }
+
+    float PathShortcutter::ReplacementCost(const std::vector<PathPoint> &points, const uint32_t begin,
+                                           const uint32_t end, const std::vector<PathPoint> &samples) const
+    {
+        float length = 0.0f;
+        int switches = 0;
+        // 起点之前没有运动时, 第一段的方向不算换挡
+        bool forward = begin == 0 ? samples.front().forward : points[begin].forward;
+        const PathPoint *prev = &points[begin];
+        for (const PathPoint &pt : samples)
+        {
+            length += hypotf(pt.x - prev->x, pt.y - prev->y) * (pt.forward ? 1.0f : m_config.reversePenalty);
+            switches += pt.forward != forward ? 1 : 0;
+            forward = pt.forward;
+            prev = &pt;
+        }
+        if (end + 1 < points.size())
+        {
+            switches += points[end + 1].forward != forward ? 1 : 0;
+        }
+        return length + m_config.gearSwitchPenalty * switches;
+    }
+
+} // namespace auto_parking_planning
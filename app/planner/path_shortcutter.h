@@ -0,0 +1,86 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-24 20:16:52
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-24 20:16:52
+ */
+
+#ifndef __PATH_SHORTCUTTER_H__
+#define __PATH_SHORTCUTTER_H__
+
+#include "collision_checker.h"
+#include "planner_types.h"
+#include "reeds_shepp.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct PathShortcutConfig
+    {
+        /// 每次尝试的捷径数, 由 seed 确定, 相同输入总得到相同结果
+        int candidates = 128;
+        uint32_t seed = 1;
+        /// 捷径两端的采样点下标间隔范围
+        int minSpan = 4;
+        int maxSpan = 160;
+        float sampleInterval = 0.1f;
+        /// 代价: 倒车段长度乘以 reversePenalty, 每次换挡加 gearSwitchPenalty
+        float reversePenalty = 1.5f;
+        float gearSwitchPenalty = 4.0f;
+        /// 代价下降不足该值的捷径不采用
+        float minGain = 0.05f;
+        /// 每个并行任务处理的捷径数
+        int grain = 16;
+    };
+
+    /// @brief 捷径后处理: 随机选取路径上的点对, 以 Reeds-Shepp 曲线连接,
+    /// 在任务调度器上并行地做批量碰撞检测并计算代价下降, 再按下降量贪心合并互不重叠的捷径
+    class PathShortcutter
+    {
+    public:
+        PathShortcutter(const PathShortcutConfig &config, const CollisionChecker *checker);
+
+        /// @brief 返回采用的捷径数. 超过 deadline 后不再评估剩余的候选捷径, 只合并已评估的;
+        /// 因此给定 deadline 时结果可能随执行快慢变化
+        int Shortcut(PlannedPath *path,
+                     const std::chrono::steady_clock::time_point &deadline =
+                         std::chrono::steady_clock::time_point::max());
+
+    private:
+        struct Candidate
+        {
+            uint32_t begin = 0;
+            uint32_t end = 0;
+            ReedsSheppPath curve;
+            float gain = 0.0f;
+            uint32_t checks = 0;
+            bool valid = false;
+        };
+
+        /// @brief 在工作线程中执行, 只读路径与检测器, 结果写入 candidate
+        void Evaluate(const std::vector<PathPoint> &points, Candidate *candidate,
+                      std::vector<PathPoint> *samples) const;
+
+        /// @brief 路径 (begin, end] 段的代价, 含两端与相邻段之间的换挡
+        float SpanCost(const std::vector<PathPoint> &points, const uint32_t begin, const uint32_t end) const;
+
+        /// @brief 以 samples 替换 (begin, end] 段后的代价
+        float ReplacementCost(const std::vector<PathPoint> &points, const uint32_t begin, const uint32_t end,
+                              const std::vector<PathPoint> &samples) const;
+
+    private:
+        PathShortcutConfig m_config;
+        const CollisionChecker *m_checker;
+        ReedsShepp m_rs;
+        /// 第 k 个点之前各段的加权长度与换挡次数的前缀和
+        std::vector<float> m_prefixLength;
+        std::vector<uint32_t> m_prefixSwitches;
+        std::vector<Candidate> m_candidates;
+        std::vector<PathPoint> m_output;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PATH_SHORTCUTTER_H__ */
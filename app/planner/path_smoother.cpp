@@ -0,0 +1,102 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 10:35:02
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 10:35:02
+ */
+#include "path_smoother.h"
+#include "math/math_utils.h"
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr size_t kMinSegmentPoints = 5;
+    }
+
+    PathSmoother::PathSmoother(const PathSmootherConfig &config, const CollisionChecker *checker)
+        : m_config(config), m_checker(checker)
+    {
+    }
+
+    bool PathSmoother::SmoothSegment(std::vector<PathPoint> *points, const size_t begin, const size_t end,
+                                     const std::chrono::steady_clock::time_point &deadline) const
+    {
+        std::vector<PathPoint> &pts = *points;
+        const float h = m_checker->Map().m_res;
+        bool in_time = true;
+        for (int iter = 0; iter < m_config.iterations; ++iter)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                in_time = false;
+                break;
+            }
+            for (size_t i = begin + 1; i + 1 < end; ++i)
+            {
+                float dx = m_config.smoothWeight * (pts[i - 1].x + pts[i + 1].x - 2.0f * pts[i].x);
+                float dy = m_config.smoothWeight * (pts[i - 1].y + pts[i + 1].y - 2.0f * pts[i].y);
+
+                const float d = m_checker->Clearance(pts[i].x, pts[i].y);
+                if (d < m_config.obstacleRange)
+                {
+                    const float gx = m_checker->Clearance(pts[i].x + h, pts[i].y) -
+                                     m_checker->Clearance(pts[i].x - h, pts[i].y);
+                    const float gy = m_checker->Clearance(pts[i].x, pts[i].y + h) -
+                                     m_checker->Clearance(pts[i].x, pts[i].y - h);
+                    const float norm = hypotf(gx, gy);
+                    if (norm > kMathEpsilon)
+                    {
+                        const float push = m_config.obstacleWeight * (m_config.obstacleRange - d);
+                        dx += push * gx / norm;
+                        dy += push * gy / norm;
+                    }
+                }
+                pts[i].x += m_config.stepSize * dx;
+                pts[i].y += m_config.stepSize * dy;
+            }
+        }
+
+        for (size_t i = begin + 1; i + 1 < end; ++i)
+        {
+            float yaw = atan2f(pts[i + 1].y - pts[i - 1].y, pts[i + 1].x - pts[i - 1].x);
+            if (!pts[i].forward)
+            {
+                yaw += static_cast<float>(M_PI);
+            }
+            pts[i].yaw = NormalizeAngle(yaw);
+        }
+        return in_time;
+    }
+
+    bool PathSmoother::Smooth(PlannedPath *path, const std::chrono::steady_clock::time_point &deadline) const
+    {
+        std::vector<PathPoint> points = path->points;
+        size_t begin = 0;
+        for (size_t i = 1; i <= points.size(); ++i)
+        {
+            // 以换挡点切分, 换挡点属于前后两段的公共端点
+            if (i == points.size() || points[i].forward != points[i - 1].forward)
+            {
+                if (i - begin >= kMinSegmentPoints && !SmoothSegment(&points, begin, i, deadline))
+                {
+                    // 到期, 后面的段保持原样
+                    break;
+                }
+                begin = i - 1;
+            }
+        }
+
+        for (const auto &pt : points)
+        {
+            if (!m_checker->IsFree(pt.x, pt.y, pt.yaw))
+            {
+                return false;
+            }
+        }
+        path->points.swap(points);
+        return true;
+    }
+
+} // namespace auto_parking_planning
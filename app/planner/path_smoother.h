@@ -0,0 +1,50 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 10:12:40
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 10:12:40
+ */
+
+#ifndef __PATH_SMOOTHER_H__
+#define __PATH_SMOOTHER_H__
+
+#include "collision_checker.h"
+#include "planner_types.h"
+#include <chrono>
+
+namespace auto_parking_planning
+{
+    struct PathSmootherConfig
+    {
+        int iterations = 40;
+        float stepSize = 0.2f;
+        float smoothWeight = 1.0f;
+        float obstacleWeight = 0.5f;
+        /// 距障碍物小于该距离时施加斥力
+        float obstacleRange = 1.5f;
+    };
+
+    /// @brief 梯度下降平滑, 换挡点与首尾固定, 结果碰撞时保留原路径
+    class PathSmoother
+    {
+    public:
+        PathSmoother(const PathSmootherConfig &config, const CollisionChecker *checker);
+
+        /// @brief 返回是否采用了平滑结果. 超过 deadline 后停止迭代, 对已完成的迭代结果做碰撞校验后采用
+        bool Smooth(PlannedPath *path,
+                    const std::chrono::steady_clock::time_point &deadline =
+                        std::chrono::steady_clock::time_point::max()) const;
+
+    private:
+        /// @brief 到期时返回 false, 段内已完成的迭代保留
+        bool SmoothSegment(std::vector<PathPoint> *points, const size_t begin, const size_t end,
+                           const std::chrono::steady_clock::time_point &deadline) const;
+
+    private:
+        PathSmootherConfig m_config;
+        const CollisionChecker *m_checker;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PATH_SMOOTHER_H__ */
@@ -0,0 +1,59 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 20:05:51
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 20:05:51
+ */
+#include "planner_types.h"
+#include <cmath>
+
+namespace auto_parking_planning
+{
+
+    float PlannedPath::Length() const
+    {
+        float length = 0.0f;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            length += hypotf(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+        }
+        return length;
+    }
+
+    int PlannedPath::GearSwitches() const
+    {
+        int switches = 0;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            if (points[i].forward != points[i - 1].forward)
+            {
+                ++switches;
+            }
+        }
+        return switches;
+    }
+
+    float PlannedPath::Cost(const float reverse_penalty, const float gear_switch_penalty) const
+    {
+        float cost = 0.0f;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            const float step = hypotf(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+            cost += points[i].forward ? step : step * reverse_penalty;
+            cost += points[i].forward != points[i - 1].forward ? gear_switch_penalty : 0.0f;
+        }
+        return cost;
+    }
+
+    xviz::Path2f PlannedPath::ToPath2f() const
+    {
+        xviz::Path2f path;
+        path.points.reserve(points.size());
+        for (const auto &pt : points)
+        {
+            path.points.emplace_back(pt.x, pt.y);
+        }
+        return path;
+    }
+
+} // namespace auto_parking_planning
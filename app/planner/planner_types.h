@@ -0,0 +1,106 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 19:52:36
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 19:52:36
+ */
+
+#ifndef __PLANNER_TYPES_H__
+#define __PLANNER_TYPES_H__
+
+#include "data_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    struct PathPoint
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float yaw = 0.0f;
+        bool forward = true;
+    };
+
+    struct PlannedPath
+    {
+        std::vector<PathPoint> points;
+
+        float Length() const;
+
+        int GearSwitches() const;
+
+        /// @brief 行驶代价: 倒车段长度乘以 reverse_penalty, 每次换挡加 gear_switch_penalty
+        float Cost(const float reverse_penalty, const float gear_switch_penalty) const;
+
+        xviz::Path2f ToPath2f() const;
+    };
+
+    enum class PlanStatus
+    {
+        SUCCESS = 0,
+        INVALID_START = 1,
+        INVALID_GOAL = 2,
+        NO_PATH = 3,
+        MEMORY_LIMIT = 4,
+        CANCELLED = 5,
+        /// 限时规划到期时仍未找到路径
+        TIMEOUT = 6,
+    };
+
+    inline const char *ToString(const PlanStatus status)
+    {
+        switch (status)
+        {
+        case PlanStatus::SUCCESS:
+            return "success";
+        case PlanStatus::INVALID_START:
+            return "invalid_start";
+        case PlanStatus::INVALID_GOAL:
+            return "invalid_goal";
+        case PlanStatus::NO_PATH:
+            return "no_path";
+        case PlanStatus::MEMORY_LIMIT:
+            return "memory_limit";
+        case PlanStatus::CANCELLED:
+            return "cancelled";
+        case PlanStatus::TIMEOUT:
+            return "timeout";
+        }
+        return "unknown";
+    }
+
+    struct PlanStats
+    {
+        double totalMs = 0.0;
+        double searchMs = 0.0;
+        double shortcutMs = 0.0;
+        double smoothingMs = 0.0;
+        uint32_t expansions = 0;
+        uint32_t collisionChecks = 0;
+        size_t searchMemory = 0;
+        /// 由解析式机动直接求解, 未进入搜索
+        bool geometric = false;
+        /// 搜索次数, 限时规划每个启发权重各一次
+        uint32_t searchRuns = 0;
+        /// 捷径后处理采用的捷径数
+        int shortcuts = 0;
+    };
+
+    struct PlanResult
+    {
+        PlanStatus status = PlanStatus::NO_PATH;
+        PlannedPath path;
+        PlanStats stats;
+        /// 得到该路径的搜索所用的启发权重. 解析扩展与按栅格去重的状态表使加权 A* 的次优界不成立,
+        /// 它不构成次优界; 未成功或由解析式机动求解时为 NaN
+        float heuristicWeight = std::numeric_limits<float>::quiet_NaN();
+
+        bool Success() const { return status == PlanStatus::SUCCESS; }
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PLANNER_TYPES_H__ */
@@ -0,0 +1,247 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 11:27:51
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 11:27:51
+ */
+#include "planning_pipeline.h"
+#include "common/profiler.h"
+#include "map/grid_map_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr unsigned char kObstacleValue = 100;
+
+        double ElapsedMs(const std::chrono::steady_clock::time_point &since)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+        }
+    }
+
+    PlanningPipeline::PlanningPipeline(const PlannerConfig &config)
+        : m_config(config),
+          m_checker(config.vehicle, config.safetyMargin, config.coarseToFineChecks),
+          m_geometric(config.geometric, &m_checker),
+          m_search(config.search, &m_checker),
+          m_shortcutter(config.shortcut, &m_checker),
+          m_smoother(config.smoother, &m_checker),
+          m_simplifier(config.obstacleTolerance)
+    {
+    }
+
+    void PlanningPipeline::SetMap(const xviz::GridMap &map, const ObstacleView &obstacles)
+    {
+        m_map = map;
+        if (!obstacles.Empty())
+        {
+            // 额外障碍物需要写入栅格, 此时才拷贝一份
+            m_grid.assign(map.m_data, map.m_data + GridCellCount(map));
+            m_map.m_data = m_grid.data();
+            if (m_simplifier.Tolerance() > 0.0f)
+            {
+                // 感知多边形顶点密集, 化简后扫描线填充需要遍历的边更少
+                ObstacleView simplified = obstacles;
+                m_simplifier.SimplifyPolygons(obstacles.polygonOffsets, obstacles.vertices, &m_polygonOffsets,
+                                              &m_polygonVertices);
+                simplified.polygonOffsets = m_polygonOffsets;
+                simplified.vertices = m_polygonVertices;
+                RasterizeObstacles(simplified);
+            }
+            else
+            {
+                RasterizeObstacles(obstacles);
+            }
+        }
+        m_checker.SetMap(m_map);
+    }
+
+    void PlanningPipeline::UpdateCells(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed)
+    {
+        m_checker.UpdateCells(occupied, freed);
+    }
+
+    void PlanningPipeline::RasterizeObstacles(const ObstacleView &obstacles)
+    {
+        const int width = GridWidth(m_map);
+        const int height = GridHeight(m_map);
+        std::vector<float> gxs, gys, crossings;
+        for (size_t p = 0; p + 1 < obstacles.polygonOffsets.size(); ++p)
+        {
+            const uint32_t begin = obstacles.polygonOffsets[p];
+            const uint32_t end = obstacles.polygonOffsets[p + 1];
+            if (end - begin < 3)
+            {
+                continue;
+            }
+            gxs.clear();
+            gys.clear();
+            float min_y = 1e30f, max_y = -1e30f;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                float gx, gy;
+                WorldToGrid(m_map, obstacles.vertices[i].x, obstacles.vertices[i].y, &gx, &gy);
+                gxs.push_back(gx);
+                gys.push_back(gy);
+                min_y = std::min(min_y, gy);
+                max_y = std::max(max_y, gy);
+            }
+            // 扫描线填充, 以栅格中心判断
+            const int row0 = std::max(0, static_cast<int>(std::floor(min_y)));
+            const int row1 = std::min(height - 1, static_cast<int>(std::ceil(max_y)));
+            const size_t n = gxs.size();
+            for (int row = row0; row <= row1; ++row)
+            {
+                const float yc = row + 0.5f;
+                crossings.clear();
+                for (size_t i = 0, j = n - 1; i < n; j = i++)
+                {
+                    if ((gys[i] > yc) != (gys[j] > yc))
+                    {
+                        crossings.push_back(gxs[i] + (yc - gys[i]) * (gxs[j] - gxs[i]) / (gys[j] - gys[i]));
+                    }
+                }
+                std::sort(crossings.begin(), crossings.end());
+                unsigned char *cells = m_grid.data() + static_cast<size_t>(row) * width;
+                for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+                {
+                    const int c0 = std::max(0, static_cast<int>(std::ceil(crossings[k] - 0.5f)));
+                    const int c1 = std::min(width - 1, static_cast<int>(std::floor(crossings[k + 1] - 0.5f)));
+                    for (int c = c0; c <= c1; ++c)
+                    {
+                        cells[c] = kObstacleValue;
+                    }
+                }
+            }
+        }
+
+        for (const auto &pt : obstacles.points)
+        {
+            float gx, gy;
+            WorldToGrid(m_map, pt.x, pt.y, &gx, &gy);
+            const int cx = static_cast<int>(std::floor(gx));
+            const int cy = static_cast<int>(std::floor(gy));
+            if (IsInside(m_map, cx, cy))
+            {
+                m_grid[static_cast<size_t>(cy) * width + cx] = kObstacleValue;
+            }
+        }
+    }
+
+    PlanResult PlanningPipeline::Plan(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel)
+    {
+        return Run(start, goal, cancel, std::chrono::steady_clock::time_point::max(), false);
+    }
+
+    PlanResult PlanningPipeline::PlanAnytime(const xviz::Pose &start, const xviz::Pose &goal,
+                                             const std::chrono::steady_clock::time_point &deadline,
+                                             const CancelToken &cancel)
+    {
+        return Run(start, goal, cancel, deadline, true);
+    }
+
+    PlanResult PlanningPipeline::Run(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel,
+                                     const std::chrono::steady_clock::time_point &deadline, const bool anytime)
+    {
+        PlanResult result;
+        const auto plan_start = std::chrono::steady_clock::now();
+        m_checker.ResetCheckCount();
+
+        {
+            APP_PROFILE_SCOPE(ProfileChannel::SEARCH_TIME);
+            result.stats.geometric = m_config.enableGeometric && m_geometric.Plan(start, goal, &result.path);
+            if (result.stats.geometric)
+            {
+                result.status = PlanStatus::SUCCESS;
+            }
+            else if (anytime)
+            {
+                SearchAnytime(start, goal, cancel, deadline, &result);
+            }
+            else
+            {
+                result.status = m_search.Plan(start, goal, &result.path, cancel);
+                if (result.Success())
+                {
+                    result.heuristicWeight = m_search.HeuristicWeight();
+                }
+                result.stats.searchRuns = 1;
+                result.stats.expansions = m_search.Expansions();
+                result.stats.searchMemory = m_search.MemoryUsed();
+            }
+        }
+        if (result.Success() && cancel.IsCancelled())
+        {
+            result.status = PlanStatus::CANCELLED;
+            result.heuristicWeight = std::numeric_limits<float>::quiet_NaN();
+        }
+        result.stats.searchMs = ElapsedMs(plan_start);
+
+        // 限时规划到期后不再后处理, 直接返回已有路径; 后处理途中到期时在下一次迭代前停下
+        if (result.Success() && !result.stats.geometric && m_config.enableShortcut &&
+            std::chrono::steady_clock::now() < deadline)
+        {
+            const auto shortcut_start = std::chrono::steady_clock::now();
+            result.stats.shortcuts = m_shortcutter.Shortcut(&result.path, deadline);
+            result.stats.shortcutMs = ElapsedMs(shortcut_start);
+        }
+        if (result.Success() && m_config.enableSmoothing && std::chrono::steady_clock::now() < deadline)
+        {
+            APP_PROFILE_SCOPE(ProfileChannel::SMOOTHING_TIME);
+            const auto smooth_start = std::chrono::steady_clock::now();
+            m_smoother.Smooth(&result.path, deadline);
+            result.stats.smoothingMs = ElapsedMs(smooth_start);
+        }
+        result.stats.collisionChecks = m_checker.CheckCount();
+        result.stats.totalMs = ElapsedMs(plan_start);
+        return result;
+    }
+
+    void PlanningPipeline::SearchAnytime(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel,
+                                         const std::chrono::steady_clock::time_point &deadline, PlanResult *result)
+    {
+        const AnytimeConfig &anytime = m_config.anytime;
+        const float final_weight = std::max(1.0f, anytime.finalWeight);
+        float weight = std::max(anytime.initialWeight, final_weight);
+        float best_cost = std::numeric_limits<float>::infinity();
+        while (true)
+        {
+            // 每个权重重新搜索一次, 代价更低时才替换当前路径; 解析扩展与状态离散化使得
+            // 权重更小的搜索不一定找到更好的路径. 之前的路径在到期或失败时仍然有效
+            m_search.SetHeuristicWeight(weight);
+            const PlanStatus status = m_search.Plan(start, goal, &m_candidate, cancel, deadline);
+            ++result->stats.searchRuns;
+            result->stats.expansions += m_search.Expansions();
+            result->stats.searchMemory = std::max(result->stats.searchMemory, m_search.MemoryUsed());
+            if (status == PlanStatus::SUCCESS)
+            {
+                const float cost =
+                    m_candidate.Cost(m_config.search.reversePenalty, m_config.search.gearSwitchPenalty);
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    result->path.points.swap(m_candidate.points);
+                    result->status = status;
+                    result->heuristicWeight = weight;
+                }
+            }
+            else if (!result->Success())
+            {
+                result->status = status;
+            }
+            if (status != PlanStatus::SUCCESS || weight <= final_weight ||
+                std::chrono::steady_clock::now() >= deadline)
+            {
+                break;
+            }
+            weight = std::max(final_weight, weight - anytime.weightStep);
+        }
+        m_search.SetHeuristicWeight(m_config.search.heuristicWeight);
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,125 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 11:02:26
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 11:02:26
+ */
+
+#ifndef __PLANNING_PIPELINE_H__
+#define __PLANNING_PIPELINE_H__
+
+#include "collision_checker.h"
+#include "common/span.h"
+#include "geometric_planner.h"
+#include "hybrid_a_star.h"
+#include "math/polyline_simplifier.h"
+#include "path_shortcutter.h"
+#include "path_smoother.h"
+#include "planner_types.h"
+#include "vehicle_param.h"
+#include <chrono>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 叠加到栅格上的障碍物, 可直接引用 ScenarioView 中的数组
+    struct ObstacleView
+    {
+        /// 第 i 个多边形的顶点为 vertices[polygonOffsets[i], polygonOffsets[i + 1])
+        Span<uint32_t> polygonOffsets;
+        Span<xviz::Vec2f> vertices;
+        Span<xviz::PointXYZ> points;
+
+        bool Empty() const { return polygonOffsets.size() < 2 && points.empty(); }
+    };
+
+    /// @brief 限时规划: 启发权重从 initialWeight 起每次成功后减小 weightStep, 直到 finalWeight
+    struct AnytimeConfig
+    {
+        float initialWeight = 3.0f;
+        float weightStep = 0.5f;
+        float finalWeight = 1.0f;
+    };
+
+    struct PlannerConfig
+    {
+        VehicleParam vehicle;
+        float safetyMargin = 0.1f;
+        /// 障碍物多边形栅格化前的化简容差, 单位米, 0 为不化简.
+        /// 化简后的轮廓可能向内收缩至多该距离, 应小于安全余量
+        float obstacleTolerance = 0.0f;
+        /// 碰撞检测先在占据金字塔粗层上判定, 适合大面积空旷的地图
+        bool coarseToFineChecks = false;
+        GeometricPlannerConfig geometric;
+        /// 搜索前先尝试解析式泊车机动
+        bool enableGeometric = true;
+        HybridAStarConfig search;
+        /// 搜索得到的路径在平滑前先做捷径后处理
+        PathShortcutConfig shortcut;
+        bool enableShortcut = true;
+        PathSmootherConfig smoother;
+        bool enableSmoothing = true;
+        AnytimeConfig anytime;
+    };
+
+    /// @brief 完整规划流程: 环境构建 -> 解析式机动(失败时 Hybrid A* 搜索与捷径后处理) -> 路径平滑
+    class PlanningPipeline
+    {
+    public:
+        explicit PlanningPipeline(const PlannerConfig &config = PlannerConfig());
+
+        /// @brief 设置地图与障碍物; 无额外障碍物时直接引用 map.m_data, 需保证其在规划期间有效
+        void SetMap(const xviz::GridMap &map, const ObstacleView &obstacles = ObstacleView());
+
+        /// @brief 两次规划之间动态障碍物占据与释放的栅格, 只增量更新碰撞检测的距离场与占据栅格
+        void UpdateCells(const Span<xviz::Vec2i> &occupied, const Span<xviz::Vec2i> &freed);
+
+        /// @brief cancel 被取消时搜索提前返回 CANCELLED, 搜索完成后才取消的也不再平滑
+        PlanResult Plan(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel = CancelToken());
+
+        /// @brief 限时规划, 在 deadline 后的一个取消检查间隔内返回. 先以放大的启发权重快速得到可行路径,
+        /// 时间允许时逐步收紧权重重新搜索, 返回代价最低的路径及得到它的启发权重; 一条都没有时为 TIMEOUT.
+        /// 捷径与平滑同样受 deadline 约束, 到期时至多多出一个候选捷径或一轮平滑迭代及最后的碰撞校验.
+        /// 每次搜索开始时构建启发代价场不检查 deadline
+        PlanResult PlanAnytime(const xviz::Pose &start, const xviz::Pose &goal,
+                               const std::chrono::steady_clock::time_point &deadline,
+                               const CancelToken &cancel = CancelToken());
+
+        const CollisionChecker &Checker() const { return m_checker; }
+
+        bool RsTableLoaded() const { return m_search.RsTableLoaded(); }
+
+        /// @brief 记录搜索的容器访问序列, 仅用于基准测试
+        void SetRecorder(SearchRecorder *recorder) { m_search.SetRecorder(recorder); }
+
+        const PlannerConfig &Config() const { return m_config; }
+
+    private:
+        void RasterizeObstacles(const ObstacleView &obstacles);
+
+        PlanResult Run(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel,
+                       const std::chrono::steady_clock::time_point &deadline, const bool anytime);
+
+        void SearchAnytime(const xviz::Pose &start, const xviz::Pose &goal, const CancelToken &cancel,
+                           const std::chrono::steady_clock::time_point &deadline, PlanResult *result);
+
+    private:
+        PlannerConfig m_config;
+        CollisionChecker m_checker;
+        GeometricPlanner m_geometric;
+        HybridAStar m_search;
+        PathShortcutter m_shortcutter;
+        PathSmoother m_smoother;
+        xviz::GridMap m_map;
+        std::vector<unsigned char> m_grid;
+        /// 化简后的障碍物多边形
+        PolylineSimplifier m_simplifier;
+        std::vector<uint32_t> m_polygonOffsets;
+        std::vector<xviz::Vec2f> m_polygonVertices;
+        /// 限时规划中当前权重的搜索结果
+        PlannedPath m_candidate;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PLANNING_PIPELINE_H__ */
@@ -0,0 +1,156 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-23 19:48:05
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-23 19:48:05
+ */
+
+#ifndef __PRIMITIVE_LATTICE_H__
+#define __PRIMITIVE_LATTICE_H__
+
+#include <array>
+
+namespace auto_parking_planning
+{
+    /// @brief 运动基元的一个采样点, 以扩展起点的车体系表示
+    struct LatticeSample
+    {
+        float dx = 0.0f;
+        float dy = 0.0f;
+        float dyaw = 0.0f;
+        /// dyaw 的余弦与正弦, 用于旋转起点航向的单位向量
+        float cosYaw = 1.0f;
+        float sinYaw = 0.0f;
+    };
+
+    /// @brief 基元表的非模板视图, 第 p 条基元第 j 步位于 samples[p * steps + j].
+    /// 基元下标为 方向 * 方向盘数 + 方向盘下标, 方向 0 为前进
+    struct LatticeView
+    {
+        const LatticeSample *samples = nullptr;
+        int steerSamples = 0;
+        int steps = 0;
+
+        int Primitives() const { return 2 * steerSamples; }
+
+        const LatticeSample &At(const int primitive, const int step) const { return samples[primitive * steps + step]; }
+
+        /// @brief 基元的终点位姿增量
+        const LatticeSample &End(const int primitive) const { return At(primitive, steps - 1); }
+    };
+
+    namespace lattice_detail
+    {
+        constexpr double kPi = 3.14159265358979323846;
+
+        /// @brief 编译期正弦, 先规约到 [-pi, pi] 再做泰勒展开
+        constexpr double Sin(double x)
+        {
+            while (x > kPi)
+            {
+                x -= 2.0 * kPi;
+            }
+            while (x < -kPi)
+            {
+                x += 2.0 * kPi;
+            }
+            double term = x;
+            double sum = x;
+            for (int k = 1; k < 16; ++k)
+            {
+                term *= -x * x / ((2 * k) * (2 * k + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double Cos(const double x) { return Sin(x + 0.5 * kPi); }
+
+        constexpr double Tan(const double x) { return Sin(x) / Cos(x); }
+
+        /// @brief 与 std::ceil 一致的编译期向上取整, 只用于正数
+        constexpr int Ceil(const float x)
+        {
+            const int n = static_cast<int>(x);
+            return static_cast<float>(n) < x ? n + 1 : n;
+        }
+    }
+
+    /// @brief 编译期生成的运动基元表. Spec 给出方向盘离散数、单次扩展弧长、采样间隔与车辆参数,
+    /// 方向盘与步数的取法和 HybridAStar 运行时生成的一致. 扩展时只需一次起点航向的三角函数,
+    /// 之后每个采样点都是查表加旋转平移
+    template <typename Spec>
+    class PrimitiveLattice
+    {
+    public:
+        static constexpr int kSteerSamples = Spec::kSteerSamples;
+        static constexpr int kPrimitives = 2 * kSteerSamples;
+        static constexpr int kSteps = Spec::kStepSize / Spec::kSampleInterval > 1.0f
+                                          ? lattice_detail::Ceil(Spec::kStepSize / Spec::kSampleInterval)
+                                          : 1;
+
+        typedef std::array<LatticeSample, kPrimitives * kSteps> Table;
+
+        static constexpr Table kSamples = []() {
+            Table table{};
+            const float step = Spec::kStepSize / kSteps;
+            for (int dir = 0; dir < 2; ++dir)
+            {
+                for (int i = 0; i < kSteerSamples; ++i)
+                {
+                    const float steer = kSteerSamples == 1
+                                            ? 0.0f
+                                            : -Spec::kMaxSteer + 2.0f * Spec::kMaxSteer * i / (kSteerSamples - 1);
+                    const double curvature = lattice_detail::Tan(steer) / Spec::kWheelBase;
+                    const double ds = (dir == 0 ? 1.0 : -1.0) * step;
+                    for (int j = 0; j < kSteps; ++j)
+                    {
+                        const double s = ds * (j + 1);
+                        const double dyaw = curvature * s;
+                        LatticeSample &sample = table[(dir * kSteerSamples + i) * kSteps + j];
+                        const bool straight = curvature < 1e-6 && curvature > -1e-6;
+                        sample.dx = static_cast<float>(straight ? s : lattice_detail::Sin(dyaw) / curvature);
+                        sample.dy = static_cast<float>(straight ? 0.0 : (1.0 - lattice_detail::Cos(dyaw)) / curvature);
+                        sample.dyaw = static_cast<float>(dyaw);
+                        sample.cosYaw = static_cast<float>(lattice_detail::Cos(dyaw));
+                        sample.sinYaw = static_cast<float>(lattice_detail::Sin(dyaw));
+                    }
+                }
+            }
+            return table;
+        }();
+
+        /// @brief 运行时参数与 Spec 完全一致时才能用这张表代替积分
+        static bool Matches(const int steer_samples, const float step_size, const float sample_interval,
+                            const float wheel_base, const float max_steer)
+        {
+            return steer_samples == kSteerSamples && step_size == Spec::kStepSize &&
+                   sample_interval == Spec::kSampleInterval && wheel_base == Spec::kWheelBase &&
+                   max_steer == Spec::kMaxSteer;
+        }
+
+        static LatticeView View()
+        {
+            LatticeView view;
+            view.samples = kSamples.data();
+            view.steerSamples = kSteerSamples;
+            view.steps = kSteps;
+            return view;
+        }
+    };
+
+    /// @brief 默认搜索参数与默认车辆对应的基元表
+    struct DefaultLatticeSpec
+    {
+        static constexpr int kSteerSamples = 5;
+        static constexpr float kStepSize = 0.9f;
+        static constexpr float kSampleInterval = 0.15f;
+        static constexpr float kWheelBase = 2.8f;
+        static constexpr float kMaxSteer = 0.55f;
+    };
+
+    typedef PrimitiveLattice<DefaultLatticeSpec> DefaultLattice;
+
+} // namespace auto_parking_planning
+
+#endif /* __PRIMITIVE_LATTICE_H__ */
@@ -0,0 +1,442 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-12 19:42:50
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-12 19:42:50
+ */
+#include "reeds_shepp.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 公式编号参照 Reeds & Shepp, "Optimal paths for a car that goes both forwards and backwards", 1990
+namespace auto_parking_planning
+{
+    namespace
+    {
+        using RS = RSSegmentType;
+
+        const RSSegmentType kPathTypes[18][5] = {
+            {RS::LEFT, RS::RIGHT, RS::LEFT, RS::NOP, RS::NOP},         // 0
+            {RS::RIGHT, RS::LEFT, RS::RIGHT, RS::NOP, RS::NOP},        // 1
+            {RS::LEFT, RS::RIGHT, RS::LEFT, RS::RIGHT, RS::NOP},       // 2
+            {RS::RIGHT, RS::LEFT, RS::RIGHT, RS::LEFT, RS::NOP},       // 3
+            {RS::LEFT, RS::RIGHT, RS::STRAIGHT, RS::LEFT, RS::NOP},    // 4
+            {RS::RIGHT, RS::LEFT, RS::STRAIGHT, RS::RIGHT, RS::NOP},   // 5
+            {RS::LEFT, RS::STRAIGHT, RS::RIGHT, RS::LEFT, RS::NOP},    // 6
+            {RS::RIGHT, RS::STRAIGHT, RS::LEFT, RS::RIGHT, RS::NOP},   // 7
+            {RS::LEFT, RS::RIGHT, RS::STRAIGHT, RS::RIGHT, RS::NOP},   // 8
+            {RS::RIGHT, RS::LEFT, RS::STRAIGHT, RS::LEFT, RS::NOP},    // 9
+            {RS::RIGHT, RS::STRAIGHT, RS::RIGHT, RS::LEFT, RS::NOP},   // 10
+            {RS::LEFT, RS::STRAIGHT, RS::LEFT, RS::RIGHT, RS::NOP},    // 11
+            {RS::LEFT, RS::STRAIGHT, RS::RIGHT, RS::NOP, RS::NOP},     // 12
+            {RS::RIGHT, RS::STRAIGHT, RS::LEFT, RS::NOP, RS::NOP},     // 13
+            {RS::LEFT, RS::STRAIGHT, RS::LEFT, RS::NOP, RS::NOP},      // 14
+            {RS::RIGHT, RS::STRAIGHT, RS::RIGHT, RS::NOP, RS::NOP},    // 15
+            {RS::LEFT, RS::RIGHT, RS::STRAIGHT, RS::LEFT, RS::RIGHT},  // 16
+            {RS::RIGHT, RS::LEFT, RS::STRAIGHT, RS::RIGHT, RS::LEFT}}; // 17
+
+        constexpr double kPi = M_PI;
+        constexpr double kTwoPi = 2.0 * M_PI;
+        constexpr double kHalfPi = 0.5 * M_PI;
+        constexpr double kZero = 10.0 * std::numeric_limits<double>::epsilon();
+
+        inline double Mod2Pi(const double x)
+        {
+            double v = std::fmod(x, kTwoPi);
+            if (v < -kPi)
+            {
+                v += kTwoPi;
+            }
+            else if (v > kPi)
+            {
+                v -= kTwoPi;
+            }
+            return v;
+        }
+
+        inline void Polar(const double x, const double y, double *r, double *theta)
+        {
+            *r = std::sqrt(x * x + y * y);
+            *theta = std::atan2(y, x);
+        }
+
+        inline void TauOmega(const double u, const double v, const double xi, const double eta,
+                             const double phi, double *tau, double *omega)
+        {
+            const double delta = Mod2Pi(u - v);
+            const double a = std::sin(u) - std::sin(delta);
+            const double b = std::cos(u) - std::cos(delta) - 1.0;
+            const double t1 = std::atan2(eta * a - xi * b, xi * a + eta * b);
+            const double t2 = 2.0 * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3.0;
+            *tau = (t2 < 0.0) ? Mod2Pi(t1 + kPi) : Mod2Pi(t1);
+            *omega = Mod2Pi(*tau - u + v - phi);
+        }
+
+        class PathBuilder
+        {
+        public:
+            void Offer(const int type, const double t, const double u, const double v,
+                       const double w = 0.0, const double x = 0.0)
+            {
+                const double length = std::fabs(t) + std::fabs(u) + std::fabs(v) + std::fabs(w) + std::fabs(x);
+                if (length < m_best.totalLength || !m_best.Valid())
+                {
+                    m_best.types = kPathTypes[type];
+                    m_best.lengths[0] = t;
+                    m_best.lengths[1] = u;
+                    m_best.lengths[2] = v;
+                    m_best.lengths[3] = w;
+                    m_best.lengths[4] = x;
+                    m_best.totalLength = length;
+                }
+            }
+
+            const ReedsSheppPath &Best() const { return m_best; }
+
+        private:
+            ReedsSheppPath m_best;
+        };
+
+        // formula 8.1
+        inline bool LpSpLp(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            Polar(x - std::sin(phi), y - 1.0 + std::cos(phi), u, t);
+            if (*t >= -kZero)
+            {
+                *v = Mod2Pi(phi - *t);
+                if (*v >= -kZero)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // formula 8.2
+        inline bool LpSpRp(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            double t1, u1;
+            Polar(x + std::sin(phi), y - 1.0 - std::cos(phi), &u1, &t1);
+            u1 = u1 * u1;
+            if (u1 >= 4.0)
+            {
+                *u = std::sqrt(u1 - 4.0);
+                const double theta = std::atan2(2.0, *u);
+                *t = Mod2Pi(t1 + theta);
+                *v = Mod2Pi(*t - phi);
+                return *t >= -kZero && *v >= -kZero;
+            }
+            return false;
+        }
+
+        void CSC(const double x, const double y, const double phi, PathBuilder *builder)
+        {
+            double t, u, v;
+            if (LpSpLp(x, y, phi, &t, &u, &v))
+                builder->Offer(14, t, u, v);
+            if (LpSpLp(-x, y, -phi, &t, &u, &v)) // timeflip
+                builder->Offer(14, -t, -u, -v);
+            if (LpSpLp(x, -y, -phi, &t, &u, &v)) // reflect
+                builder->Offer(15, t, u, v);
+            if (LpSpLp(-x, -y, phi, &t, &u, &v)) // timeflip + reflect
+                builder->Offer(15, -t, -u, -v);
+            if (LpSpRp(x, y, phi, &t, &u, &v))
+                builder->Offer(12, t, u, v);
+            if (LpSpRp(-x, y, -phi, &t, &u, &v))
+                builder->Offer(12, -t, -u, -v);
+            if (LpSpRp(x, -y, -phi, &t, &u, &v))
+                builder->Offer(13, t, u, v);
+            if (LpSpRp(-x, -y, phi, &t, &u, &v))
+                builder->Offer(13, -t, -u, -v);
+        }
+
+        // formula 8.3 / 8.4
+        inline bool LpRmL(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x - std::sin(phi);
+            const double eta = y - 1.0 + std::cos(phi);
+            double u1, theta;
+            Polar(xi, eta, &u1, &theta);
+            if (u1 <= 4.0)
+            {
+                *u = -2.0 * std::asin(0.25 * u1);
+                *t = Mod2Pi(theta + 0.5 * *u + kPi);
+                *v = Mod2Pi(phi - *t + *u);
+                return *t >= -kZero && *u <= kZero;
+            }
+            return false;
+        }
+
+        void CCC(const double x, const double y, const double phi, PathBuilder *builder)
+        {
+            double t, u, v;
+            if (LpRmL(x, y, phi, &t, &u, &v))
+                builder->Offer(0, t, u, v);
+            if (LpRmL(-x, y, -phi, &t, &u, &v))
+                builder->Offer(0, -t, -u, -v);
+            if (LpRmL(x, -y, -phi, &t, &u, &v))
+                builder->Offer(1, t, u, v);
+            if (LpRmL(-x, -y, phi, &t, &u, &v))
+                builder->Offer(1, -t, -u, -v);
+
+            // backwards
+            const double xb = x * std::cos(phi) + y * std::sin(phi);
+            const double yb = x * std::sin(phi) - y * std::cos(phi);
+            if (LpRmL(xb, yb, phi, &t, &u, &v))
+                builder->Offer(0, v, u, t);
+            if (LpRmL(-xb, yb, -phi, &t, &u, &v))
+                builder->Offer(0, -v, -u, -t);
+            if (LpRmL(xb, -yb, -phi, &t, &u, &v))
+                builder->Offer(1, v, u, t);
+            if (LpRmL(-xb, -yb, phi, &t, &u, &v))
+                builder->Offer(1, -v, -u, -t);
+        }
+
+        // formula 8.7
+        inline bool LpRupLumRm(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x + std::sin(phi);
+            const double eta = y - 1.0 - std::cos(phi);
+            const double rho = 0.25 * (2.0 + std::sqrt(xi * xi + eta * eta));
+            if (rho <= 1.0)
+            {
+                *u = std::acos(rho);
+                TauOmega(*u, -*u, xi, eta, phi, t, v);
+                return *t >= -kZero && *v <= kZero;
+            }
+            return false;
+        }
+
+        // formula 8.8
+        inline bool LpRumLumRp(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x + std::sin(phi);
+            const double eta = y - 1.0 - std::cos(phi);
+            const double rho = (20.0 - xi * xi - eta * eta) / 16.0;
+            if (rho >= 0.0 && rho <= 1.0)
+            {
+                *u = -std::acos(rho);
+                if (*u >= -kHalfPi)
+                {
+                    TauOmega(*u, *u, xi, eta, phi, t, v);
+                    return *t >= -kZero && *v >= -kZero;
+                }
+            }
+            return false;
+        }
+
+        void CCCC(const double x, const double y, const double phi, PathBuilder *builder)
+        {
+            double t, u, v;
+            if (LpRupLumRm(x, y, phi, &t, &u, &v))
+                builder->Offer(2, t, u, -u, v);
+            if (LpRupLumRm(-x, y, -phi, &t, &u, &v))
+                builder->Offer(2, -t, -u, u, -v);
+            if (LpRupLumRm(x, -y, -phi, &t, &u, &v))
+                builder->Offer(3, t, u, -u, v);
+            if (LpRupLumRm(-x, -y, phi, &t, &u, &v))
+                builder->Offer(3, -t, -u, u, -v);
+
+            if (LpRumLumRp(x, y, phi, &t, &u, &v))
+                builder->Offer(2, t, u, u, v);
+            if (LpRumLumRp(-x, y, -phi, &t, &u, &v))
+                builder->Offer(2, -t, -u, -u, -v);
+            if (LpRumLumRp(x, -y, -phi, &t, &u, &v))
+                builder->Offer(3, t, u, u, v);
+            if (LpRumLumRp(-x, -y, phi, &t, &u, &v))
+                builder->Offer(3, -t, -u, -u, -v);
+        }
+
+        // formula 8.9
+        inline bool LpRmSmLm(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x - std::sin(phi);
+            const double eta = y - 1.0 + std::cos(phi);
+            double rho, theta;
+            Polar(xi, eta, &rho, &theta);
+            if (rho >= 2.0)
+            {
+                const double r = std::sqrt(rho * rho - 4.0);
+                *u = 2.0 - r;
+                *t = Mod2Pi(theta + std::atan2(r, -2.0));
+                *v = Mod2Pi(phi - kHalfPi - *t);
+                return *t >= -kZero && *u <= kZero && *v <= kZero;
+            }
+            return false;
+        }
+
+        // formula 8.10
+        inline bool LpRmSmRm(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x + std::sin(phi);
+            const double eta = y - 1.0 - std::cos(phi);
+            double rho, theta;
+            Polar(-eta, xi, &rho, &theta);
+            if (rho >= 2.0)
+            {
+                *t = theta;
+                *u = 2.0 - rho;
+                *v = Mod2Pi(*t + kHalfPi - phi);
+                return *t >= -kZero && *u <= kZero && *v <= kZero;
+            }
+            return false;
+        }
+
+        void CCSC(const double x, const double y, const double phi, PathBuilder *builder)
+        {
+            double t, u, v;
+            if (LpRmSmLm(x, y, phi, &t, &u, &v))
+                builder->Offer(4, t, -kHalfPi, u, v);
+            if (LpRmSmLm(-x, y, -phi, &t, &u, &v))
+                builder->Offer(4, -t, kHalfPi, -u, -v);
+            if (LpRmSmLm(x, -y, -phi, &t, &u, &v))
+                builder->Offer(5, t, -kHalfPi, u, v);
+            if (LpRmSmLm(-x, -y, phi, &t, &u, &v))
+                builder->Offer(5, -t, kHalfPi, -u, -v);
+
+            if (LpRmSmRm(x, y, phi, &t, &u, &v))
+                builder->Offer(8, t, -kHalfPi, u, v);
+            if (LpRmSmRm(-x, y, -phi, &t, &u, &v))
+                builder->Offer(8, -t, kHalfPi, -u, -v);
+            if (LpRmSmRm(x, -y, -phi, &t, &u, &v))
+                builder->Offer(9, t, -kHalfPi, u, v);
+            if (LpRmSmRm(-x, -y, phi, &t, &u, &v))
+                builder->Offer(9, -t, kHalfPi, -u, -v);
+
+            // backwards
+            const double xb = x * std::cos(phi) + y * std::sin(phi);
+            const double yb = x * std::sin(phi) - y * std::cos(phi);
+            if (LpRmSmLm(xb, yb, phi, &t, &u, &v))
+                builder->Offer(6, v, u, -kHalfPi, t);
+            if (LpRmSmLm(-xb, yb, -phi, &t, &u, &v))
+                builder->Offer(6, -v, -u, kHalfPi, -t);
+            if (LpRmSmLm(xb, -yb, -phi, &t, &u, &v))
+                builder->Offer(7, v, u, -kHalfPi, t);
+            if (LpRmSmLm(-xb, -yb, phi, &t, &u, &v))
+                builder->Offer(7, -v, -u, kHalfPi, -t);
+
+            if (LpRmSmRm(xb, yb, phi, &t, &u, &v))
+                builder->Offer(10, v, u, -kHalfPi, t);
+            if (LpRmSmRm(-xb, yb, -phi, &t, &u, &v))
+                builder->Offer(10, -v, -u, kHalfPi, -t);
+            if (LpRmSmRm(xb, -yb, -phi, &t, &u, &v))
+                builder->Offer(11, v, u, -kHalfPi, t);
+            if (LpRmSmRm(-xb, -yb, phi, &t, &u, &v))
+                builder->Offer(11, -v, -u, kHalfPi, -t);
+        }
+
+        // formula 8.11
+        inline bool LpRmSLmRp(const double x, const double y, const double phi, double *t, double *u, double *v)
+        {
+            const double xi = x + std::sin(phi);
+            const double eta = y - 1.0 - std::cos(phi);
+            double rho, theta;
+            Polar(xi, eta, &rho, &theta);
+            if (rho >= 2.0)
+            {
+                *u = 4.0 - std::sqrt(rho * rho - 4.0);
+                if (*u <= kZero)
+                {
+                    *t = Mod2Pi(std::atan2((4.0 - *u) * xi - 2.0 * eta, -2.0 * xi + (*u - 4.0) * eta));
+                    *v = Mod2Pi(*t - phi);
+                    return *t >= -kZero && *v >= -kZero;
+                }
+            }
+            return false;
+        }
+
+        void CCSCC(const double x, const double y, const double phi, PathBuilder *builder)
+        {
+            double t, u, v;
+            if (LpRmSLmRp(x, y, phi, &t, &u, &v))
+                builder->Offer(16, t, -kHalfPi, u, -kHalfPi, v);
+            if (LpRmSLmRp(-x, y, -phi, &t, &u, &v))
+                builder->Offer(16, -t, kHalfPi, -u, kHalfPi, -v);
+            if (LpRmSLmRp(x, -y, -phi, &t, &u, &v))
+                builder->Offer(17, t, -kHalfPi, u, -kHalfPi, v);
+            if (LpRmSLmRp(-x, -y, phi, &t, &u, &v))
+                builder->Offer(17, -t, kHalfPi, -u, kHalfPi, -v);
+        }
+    }
+
+    ReedsShepp::ReedsShepp(const float turning_radius) : m_radius(turning_radius) {}
+
+    ReedsSheppPath ReedsShepp::ShortestPath(const float x0, const float y0, const float yaw0,
+                                            const float x1, const float y1, const float yaw1) const
+    {
+        const double dx = x1 - x0;
+        const double dy = y1 - y0;
+        const double c = std::cos(yaw0);
+        const double s = std::sin(yaw0);
+        const double x = (c * dx + s * dy) / m_radius;
+        const double y = (-s * dx + c * dy) / m_radius;
+        const double phi = static_cast<double>(yaw1) - yaw0;
+
+        PathBuilder builder;
+        CSC(x, y, phi, &builder);
+        CCC(x, y, phi, &builder);
+        CCCC(x, y, phi, &builder);
+        CCSC(x, y, phi, &builder);
+        CCSCC(x, y, phi, &builder);
+        return builder.Best();
+    }
+
+    float ReedsShepp::Distance(const float x0, const float y0, const float yaw0,
+                               const float x1, const float y1, const float yaw1) const
+    {
+        return static_cast<float>(ShortestPath(x0, y0, yaw0, x1, y1, yaw1).totalLength) * m_radius;
+    }
+
+    void ReedsShepp::Sample(const float x0, const float y0, const float yaw0,
+                            const ReedsSheppPath &path, const float step,
+                            std::vector<PathPoint> *points) const
+    {
+        if (!path.Valid())
+        {
+            return;
+        }
+        double x = x0, y = y0, yaw = yaw0;
+        const double unit_step = step / m_radius;
+        for (int i = 0; i < ReedsSheppPath::kMaxSegments; ++i)
+        {
+            const RSSegmentType type = path.types[i];
+            const double length = path.lengths[i];
+            if (type == RSSegmentType::NOP || std::fabs(length) < kZero)
+            {
+                continue;
+            }
+            const double sign = length > 0.0 ? 1.0 : -1.0;
+            const int n = std::max(1, static_cast<int>(std::ceil(std::fabs(length) / unit_step)));
+            const double ds = length / n;
+            for (int k = 0; k < n; ++k)
+            {
+                switch (type)
+                {
+                case RSSegmentType::LEFT:
+                    x += (std::sin(yaw + ds) - std::sin(yaw)) * m_radius;
+                    y += (-std::cos(yaw + ds) + std::cos(yaw)) * m_radius;
+                    yaw += ds;
+                    break;
+                case RSSegmentType::RIGHT:
+                    x += (-std::sin(yaw - ds) + std::sin(yaw)) * m_radius;
+                    y += (std::cos(yaw - ds) - std::cos(yaw)) * m_radius;
+                    yaw -= ds;
+                    break;
+                default:
+                    x += ds * std::cos(yaw) * m_radius;
+                    y += ds * std::sin(yaw) * m_radius;
+                    break;
+                }
+                PathPoint pt;
+                pt.x = static_cast<float>(x);
+                pt.y = static_cast<float>(y);
+                pt.yaw = NormalizeAngle(static_cast<float>(yaw));
+                pt.forward = sign > 0.0;
+                points->push_back(pt);
+            }
+        }
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,62 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-12 19:15:27
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-12 19:15:27
+ */
+
+#ifndef __REEDS_SHEPP_H__
+#define __REEDS_SHEPP_H__
+
+#include "planner_types.h"
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    enum class RSSegmentType : uint8_t
+    {
+        NOP = 0,
+        LEFT = 1,
+        STRAIGHT = 2,
+        RIGHT = 3,
+    };
+
+    /// @brief Reeds-Shepp 曲线, 段长以转弯半径归一化, 负值表示倒车
+    struct ReedsSheppPath
+    {
+        static constexpr int kMaxSegments = 5;
+
+        const RSSegmentType *types = nullptr;
+        double lengths[kMaxSegments] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        double totalLength = 0.0;
+
+        bool Valid() const { return types != nullptr; }
+    };
+
+    class ReedsShepp
+    {
+    public:
+        explicit ReedsShepp(const float turning_radius);
+
+        float TurningRadius() const { return m_radius; }
+
+        ReedsSheppPath ShortestPath(const float x0, const float y0, const float yaw0,
+                                    const float x1, const float y1, const float yaw1) const;
+
+        /// @brief 最短 Reeds-Shepp 路径长度, 单位米
+        float Distance(const float x0, const float y0, const float yaw0,
+                       const float x1, const float y1, const float yaw1) const;
+
+        /// @brief 按间隔 step 采样路径, 不包含起点, 包含终点
+        void Sample(const float x0, const float y0, const float yaw0,
+                    const ReedsSheppPath &path, const float step,
+                    std::vector<PathPoint> *points) const;
+
+    private:
+        float m_radius;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __REEDS_SHEPP_H__ */
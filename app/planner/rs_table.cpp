@@ -0,0 +1,151 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-18 20:41:09
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-18 20:41:09
+ */
+#include "rs_table.h"
+#include "math/math_utils.h"
+#include "reeds_shepp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kRadiusTolerance = 1e-3f;
+    }
+
+    bool ReedsSheppTable::Generate(const ReedsSheppTableSpec &spec, const std::string &path)
+    {
+        if (spec.resolution <= 0.0f || spec.range <= 0.0f || spec.headingBins == 0 || spec.turningRadius <= 0.0f)
+        {
+            return false;
+        }
+        const uint32_t half = static_cast<uint32_t>(std::lround(spec.range / spec.resolution));
+        const uint32_t cols = 2 * half + 1;
+        const uint32_t rows = half + 1;
+        const float range = half * spec.resolution;
+        const float bin_size = 2.0f * static_cast<float>(M_PI) / spec.headingBins;
+
+        const ReedsShepp rs(spec.turningRadius);
+        std::vector<float> costs(static_cast<size_t>(cols) * rows * spec.headingBins);
+        size_t i = 0;
+        for (uint32_t bin = 0; bin < spec.headingBins; ++bin)
+        {
+            for (uint32_t row = 0; row < rows; ++row)
+            {
+                for (uint32_t col = 0; col < cols; ++col)
+                {
+                    costs[i++] = rs.Distance(0.0f, 0.0f, 0.0f, col * spec.resolution - range,
+                                             row * spec.resolution, NormalizeAngle(bin * bin_size));
+                }
+            }
+        }
+
+        ReedsSheppTableHeader header = {};
+        std::memcpy(header.magic, kReedsSheppTableMagic, sizeof(header.magic));
+        header.version = kReedsSheppTableVersion;
+        header.headerSize = sizeof(ReedsSheppTableHeader);
+        header.turningRadius = spec.turningRadius;
+        header.resolution = spec.resolution;
+        header.range = range;
+        header.cols = cols;
+        header.rows = rows;
+        header.headingBins = spec.headingBins;
+        header.dataOffset = sizeof(ReedsSheppTableHeader);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(costs.data()),
+                  static_cast<std::streamsize>(costs.size() * sizeof(float)));
+        return out.good();
+    }
+
+    bool ReedsSheppTable::Load(const std::string &path, const float turning_radius)
+    {
+        Close();
+        if (!m_file.Open(path) || m_file.Size() < sizeof(ReedsSheppTableHeader))
+        {
+            Close();
+            return false;
+        }
+        const auto *header = reinterpret_cast<const ReedsSheppTableHeader *>(m_file.Data());
+        const uint64_t count = static_cast<uint64_t>(header->cols) * header->rows * header->headingBins;
+        if (std::memcmp(header->magic, kReedsSheppTableMagic, sizeof(header->magic)) != 0 ||
+            header->version != kReedsSheppTableVersion ||
+            header->headerSize != sizeof(ReedsSheppTableHeader) ||
+            std::fabs(header->turningRadius - turning_radius) > kRadiusTolerance ||
+            header->resolution <= 0.0f || count == 0 ||
+            header->dataOffset % sizeof(float) != 0 ||
+            header->dataOffset > m_file.Size() ||
+            count * sizeof(float) > m_file.Size() - header->dataOffset)
+        {
+            Close();
+            return false;
+        }
+
+        m_data = reinterpret_cast<const float *>(m_file.Data() + header->dataOffset);
+        m_spec.turningRadius = header->turningRadius;
+        m_spec.resolution = header->resolution;
+        m_spec.range = header->range;
+        m_spec.headingBins = header->headingBins;
+        m_cols = static_cast<int>(header->cols);
+        m_rows = static_cast<int>(header->rows);
+        m_invRes = 1.0f / header->resolution;
+        m_invBin = header->headingBins / (2.0f * static_cast<float>(M_PI));
+        return true;
+    }
+
+    void ReedsSheppTable::Close()
+    {
+        m_data = nullptr;
+        m_cols = 0;
+        m_rows = 0;
+        m_file.Close();
+    }
+
+    bool ReedsSheppTable::Lookup(const float x0, const float y0, const float yaw0, const float x1, const float y1,
+                                 const float yaw1, float *cost) const
+    {
+        // 终点变换到起点系, dy < 0 时关于 x 轴镜像
+        const float c = cosf(yaw0);
+        const float s = sinf(yaw0);
+        const float dx = c * (x1 - x0) + s * (y1 - y0);
+        float dy = -s * (x1 - x0) + c * (y1 - y0);
+        float dyaw = yaw1 - yaw0;
+        if (dy < 0.0f)
+        {
+            dy = -dy;
+            dyaw = -dyaw;
+        }
+
+        const float fx = (dx + m_spec.range) * m_invRes;
+        const float fy = dy * m_invRes;
+        if (fx < 0.0f || fx >= m_cols - 1 || fy >= m_rows - 1)
+        {
+            return false;
+        }
+        const float ft = WrapAngle(dyaw) * m_invBin;
+
+        const int ix = static_cast<int>(fx);
+        const int iy = static_cast<int>(fy);
+        const int it0 = static_cast<int>(ft) % static_cast<int>(m_spec.headingBins);
+        const int it1 = (it0 + 1) % static_cast<int>(m_spec.headingBins);
+
+        // 取周围 8 个采样的最小值而非插值: 距离在采样间不连续, 插值会高估, 启发函数不再可采纳
+        float lowest = At(ix, iy, it0);
+        for (const int bin : {it0, it1})
+        {
+            lowest = std::min(lowest, std::min(std::min(At(ix, iy, bin), At(ix + 1, iy, bin)),
+                                               std::min(At(ix, iy + 1, bin), At(ix + 1, iy + 1, bin))));
+        }
+        *cost = lowest;
+        return true;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,89 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-18 20:05:31
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-18 20:05:31
+ */
+
+#ifndef __RS_TABLE_H__
+#define __RS_TABLE_H__
+
+#include "common/mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace auto_parking_planning
+{
+    // Reeds-Shepp 代价表文件布局(主机字节序):
+    //   ReedsSheppTableHeader | float cost[headingBins][rows][cols]
+    // 代价为无障碍时终点相对起点的最短 Reeds-Shepp 路径长度, 单位米.
+    // 起点系下 dx 取 [-range, range], 利用关于 x 轴的对称性 dy 只存 [0, range]
+
+    constexpr char kReedsSheppTableMagic[8] = {'A', 'P', 'P', 'R', 'S', 'T', 'B', 'L'};
+    constexpr uint32_t kReedsSheppTableVersion = 1;
+
+    struct ReedsSheppTableHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        float turningRadius;
+        float resolution;
+        float range;
+        uint32_t cols;
+        uint32_t rows;
+        uint32_t headingBins;
+        uint64_t dataOffset;
+    };
+
+    static_assert(sizeof(ReedsSheppTableHeader) == 48, "ReedsSheppTableHeader layout changed");
+    static_assert(std::is_trivially_copyable<ReedsSheppTableHeader>::value, "header must be POD");
+
+    struct ReedsSheppTableSpec
+    {
+        float turningRadius = 1.0f;
+        float resolution = 0.25f;
+        float range = 15.0f;
+        uint32_t headingBins = 72;
+    };
+
+    /// @brief 内存映射的 Reeds-Shepp 代价表, 查询取周围 8 个采样的最小值
+    class ReedsSheppTable
+    {
+    public:
+        /// @brief 离线生成代价表并写入 path
+        static bool Generate(const ReedsSheppTableSpec &spec, const std::string &path);
+
+        /// @brief 映射代价表, 转弯半径与 turning_radius 不一致时拒绝加载
+        bool Load(const std::string &path, const float turning_radius);
+
+        void Close();
+
+        bool Loaded() const { return m_data != nullptr; }
+
+        /// @brief 查询位姿间代价的下界, 相对位置超出表范围时返回 false
+        bool Lookup(const float x0, const float y0, const float yaw0, const float x1, const float y1,
+                    const float yaw1, float *cost) const;
+
+        const ReedsSheppTableSpec &Spec() const { return m_spec; }
+
+    private:
+        float At(const int col, const int row, const int bin) const
+        {
+            return m_data[(static_cast<size_t>(bin) * m_rows + row) * m_cols + col];
+        }
+
+    private:
+        MappedFile m_file;
+        const float *m_data = nullptr;
+        ReedsSheppTableSpec m_spec;
+        int m_cols = 0;
+        int m_rows = 0;
+        float m_invRes = 1.0f;
+        float m_invBin = 1.0f;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __RS_TABLE_H__ */
@@ -0,0 +1,53 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-15 21:08:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-15 21:08:12
+ */
+
+#ifndef __SEARCH_RECORDER_H__
+#define __SEARCH_RECORDER_H__
+
+#include <cstdint>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    /// @brief 记录一次搜索对内部容器的访问序列, 供基准测试离线回放并比较不同容器实现
+    struct SearchRecorder
+    {
+        enum class OpenOp : uint8_t
+        {
+            PUSH = 0,
+            UPDATE,
+            POP,
+        };
+
+        struct OpenAccess
+        {
+            OpenOp op;
+            uint32_t handle;
+            float key;
+        };
+
+        /// 状态表的查找或插入
+        std::vector<uint64_t> stateKeys;
+        std::vector<OpenAccess> openAccesses;
+
+        void Clear()
+        {
+            stateKeys.clear();
+            openAccesses.clear();
+        }
+
+        void RecordState(const uint64_t key) { stateKeys.push_back(key); }
+
+        void RecordOpen(const OpenOp op, const uint32_t handle, const float key)
+        {
+            openAccesses.push_back({op, handle, key});
+        }
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __SEARCH_RECORDER_H__ */
@@ -0,0 +1,182 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-15 20:31:44
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-15 20:31:44
+ */
+
+#ifndef __STATE_TABLE_H__
+#define __STATE_TABLE_H__
+
+#include "common/index_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace auto_parking_planning
+{
+    /// @brief 离散状态 key 到节点索引的开放寻址哈希表, 线性探测.
+    /// 全表为一块连续内存; 每个槽位记录写入时的代数, 代数不同即视为空槽,
+    /// 因此 Clear 只需代数加一, 也不需要墓碑.
+    /// 给定内存预算时, 整表容量与扩容都计入预算, 预算在每次规划开始时由调用方复位
+    class StateTable
+    {
+    public:
+        /// 每个槽位的字节数
+        static constexpr size_t kSlotBytes = 16;
+
+        explicit StateTable(MemoryBudget *budget = nullptr) : m_budget(budget) {}
+
+        /// @brief 每次规划开始时调用(预算已复位): 清空, 按预计状态数分配(负载因子不超过 1/2)并把整表计入预算.
+        /// 已有的更大容量在预算允许时保留, 否则缩小到预计容量; 预计容量也超出预算时返回 false
+        bool Reset(const size_t expected)
+        {
+            size_t capacity = kMinCapacity;
+            while (capacity < 2 * expected)
+            {
+                capacity <<= 1;
+            }
+            if (m_capacity >= capacity && Charge(m_capacity * sizeof(Entry)))
+            {
+                Clear();
+                return true;
+            }
+            if (!Charge(capacity * sizeof(Entry)))
+            {
+                return false;
+            }
+            // 表已清空, 直接换成新容量, 无需重新插入
+            Allocate(capacity);
+            return true;
+        }
+
+        /// @brief O(1) 清空
+        void Clear()
+        {
+            m_size = 0;
+            if (++m_generation == 0)
+            {
+                // 代数回绕时才真正清零
+                for (size_t i = 0; i < m_capacity; ++i)
+                {
+                    m_slots[i].generation = 0;
+                }
+                m_generation = 1;
+            }
+        }
+
+        /// @brief 查找 key 对应的节点索引, 不存在时返回 kInvalidIndex
+        uint32_t Find(const uint64_t key) const
+        {
+            if (m_capacity == 0)
+            {
+                return kInvalidIndex;
+            }
+            size_t i = Hash(key);
+            while (m_slots[i].generation == m_generation && m_slots[i].key != key)
+            {
+                i = (i + 1) & m_mask;
+            }
+            return m_slots[i].generation == m_generation ? m_slots[i].value : kInvalidIndex;
+        }
+
+        /// @brief 返回 key 对应值的指针, 不存在时插入 kInvalidIndex. 指针在下一次插入前有效;
+        /// 需要扩容而超出预算时返回 nullptr
+        uint32_t *Slot(const uint64_t key)
+        {
+            if (2 * (m_size + 1) > m_capacity)
+            {
+                const size_t capacity = m_capacity == 0 ? kMinCapacity : 2 * m_capacity;
+                if (!Charge((capacity - m_capacity) * sizeof(Entry)))
+                {
+                    return nullptr;
+                }
+                Rehash(capacity);
+            }
+            size_t i = Hash(key);
+            while (m_slots[i].generation == m_generation && m_slots[i].key != key)
+            {
+                i = (i + 1) & m_mask;
+            }
+            Entry &entry = m_slots[i];
+            if (entry.generation != m_generation)
+            {
+                entry.key = key;
+                entry.value = kInvalidIndex;
+                entry.generation = m_generation;
+                ++m_size;
+            }
+            return &entry.value;
+        }
+
+        size_t Size() const { return m_size; }
+
+        size_t Capacity() const { return m_capacity; }
+
+        size_t MemoryBytes() const { return m_capacity * sizeof(Entry); }
+
+    private:
+        struct Entry
+        {
+            uint64_t key;
+            uint32_t value;
+            uint32_t generation;
+        };
+
+        static_assert(sizeof(Entry) == kSlotBytes, "StateTable entry layout changed");
+
+        static constexpr size_t kMinCapacity = 1024;
+
+        size_t Hash(const uint64_t key) const
+        {
+            // Fibonacci 散列, 取高位
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> m_shift);
+        }
+
+        bool Charge(const size_t bytes) { return m_budget == nullptr || m_budget->Acquire(bytes); }
+
+        /// @brief 换成 capacity 个空槽
+        void Allocate(const size_t capacity)
+        {
+            m_slots.reset(new Entry[capacity]());
+            m_capacity = capacity;
+            m_mask = capacity - 1;
+            m_shift = 64;
+            for (size_t c = capacity; c > 1; c >>= 1)
+            {
+                --m_shift;
+            }
+            m_generation = 1;
+            m_size = 0;
+        }
+
+        void Rehash(const size_t capacity)
+        {
+            std::unique_ptr<Entry[]> old_slots(std::move(m_slots));
+            const size_t old_capacity = m_capacity;
+            const uint32_t old_generation = m_generation;
+
+            Allocate(capacity);
+            for (size_t i = 0; i < old_capacity; ++i)
+            {
+                if (old_slots[i].generation == old_generation)
+                {
+                    // 容量翻倍后不会再触发扩容
+                    *Slot(old_slots[i].key) = old_slots[i].value;
+                }
+            }
+        }
+
+    private:
+        MemoryBudget *m_budget;
+        std::unique_ptr<Entry[]> m_slots;
+        size_t m_capacity = 0;
+        size_t m_mask = 0;
+        int m_shift = 64;
+        size_t m_size = 0;
+        uint32_t m_generation = 1;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __STATE_TABLE_H__ */
@@ -0,0 +1,33 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-11 19:40:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-11 19:40:12
+ */
+
+#ifndef __VEHICLE_PARAM_H__
+#define __VEHICLE_PARAM_H__
+
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    /// @brief 车辆几何参数, 位姿参考点为后轴中心
+    struct VehicleParam
+    {
+        float length = 4.7f;
+        float width = 1.9f;
+        /// 后轴中心到车尾距离
+        float rearOverhang = 1.0f;
+        float wheelBase = 2.8f;
+        float maxSteer = 0.55f;
+
+        float MinTurningRadius() const { return wheelBase / tanf(maxSteer); }
+
+        /// 后轴中心到车头距离
+        float FrontToRear() const { return length - rearOverhang; }
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __VEHICLE_PARAM_H__ */
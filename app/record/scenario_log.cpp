@@ -0,0 +1,261 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 21:48:19
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 21:48:19
+ */
+#include "scenario_log.h"
+#include "map/grid_map_utils.h"
+#include <cstring>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr uint64_t kAlignment = 8;
+
+        uint64_t AlignUp(const uint64_t value)
+        {
+            return (value + kAlignment - 1) & ~(kAlignment - 1);
+        }
+
+        PoseRecord ToRecord(const xviz::Pose &pose)
+        {
+            PoseRecord record;
+            record.x = pose.x;
+            record.y = pose.y;
+            record.yaw = pose.yaw;
+            record.seq = pose.header.seq;
+            record.timeStamp = pose.header.timeStamp;
+            return record;
+        }
+
+        xviz::Pose FromRecord(const PoseRecord &record)
+        {
+            xviz::Pose pose(record.x, record.y, record.yaw);
+            pose.header.seq = record.seq;
+            pose.header.timeStamp = record.timeStamp;
+            return pose;
+        }
+
+        /// 追加一段数据到缓冲区末尾(先对齐), 返回其相对偏移
+        uint64_t AppendBlock(std::vector<uint8_t> *buffer, const void *data, const size_t bytes)
+        {
+            const uint64_t offset = AlignUp(buffer->size());
+            buffer->resize(offset + bytes);
+            if (bytes > 0)
+            {
+                std::memcpy(buffer->data() + offset, data, bytes);
+            }
+            return offset;
+        }
+
+        bool InRecord(const uint64_t offset, const uint64_t bytes, const uint64_t record_size)
+        {
+            return offset <= record_size && bytes <= record_size - offset &&
+                   offset % kAlignment == 0;
+        }
+
+        /// 偏移数组须从 0 开始, 单调不减, 末项等于顶点数, 否则多边形会越界或长度为负
+        bool ValidOffsets(const uint32_t *offsets, const uint32_t polygon_count, const uint32_t vertex_count)
+        {
+            if (offsets[0] != 0 || offsets[polygon_count] != vertex_count)
+            {
+                return false;
+            }
+            for (uint32_t k = 0; k < polygon_count; ++k)
+            {
+                if (offsets[k] > offsets[k + 1])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    ScenarioLogWriter::~ScenarioLogWriter()
+    {
+        Close();
+    }
+
+    bool ScenarioLogWriter::Open(const std::string &path)
+    {
+        Close();
+        m_out.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_out.is_open())
+        {
+            return false;
+        }
+        // 先写占位文件头, Close 时回填
+        ScenarioLogHeader header = {};
+        m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_offset = sizeof(header);
+        m_index.clear();
+        return m_out.good();
+    }
+
+    bool ScenarioLogWriter::Append(const xviz::Pose &start, const xviz::Pose &target,
+                                   const xviz::GridMap &map, const xviz::Polygons2f &polygons,
+                                   const xviz::PointCloud3f &cloud)
+    {
+        if (!m_out.is_open())
+        {
+            return false;
+        }
+
+        ScenarioRecord record = {};
+        record.start = ToRecord(start);
+        record.target = ToRecord(target);
+        record.map.res = map.m_res;
+        record.map.originX = map.m_origin.x;
+        record.map.originY = map.m_origin.y;
+        record.map.originYaw = map.m_originYaw;
+        record.map.width = static_cast<uint32_t>(GridWidth(map));
+        record.map.height = static_cast<uint32_t>(GridHeight(map));
+
+        m_buffer.assign(sizeof(ScenarioRecord), 0);
+        const size_t cells = map.m_data != nullptr ? GridCellCount(map) : 0;
+        record.map.dataOffset = AppendBlock(&m_buffer, map.m_data, cells);
+
+        std::vector<uint32_t> offsets;
+        std::vector<xviz::Vec2f> vertices;
+        offsets.reserve(polygons.polygons.size() + 1);
+        offsets.push_back(0);
+        for (const auto &polygon : polygons.polygons)
+        {
+            vertices.insert(vertices.end(), polygon.points.begin(), polygon.points.end());
+            offsets.push_back(static_cast<uint32_t>(vertices.size()));
+        }
+        record.polygonCount = static_cast<uint32_t>(polygons.polygons.size());
+        record.vertexCount = static_cast<uint32_t>(vertices.size());
+        record.polygonOffsetsOffset =
+            AppendBlock(&m_buffer, offsets.data(), offsets.size() * sizeof(uint32_t));
+        record.verticesOffset =
+            AppendBlock(&m_buffer, vertices.data(), vertices.size() * sizeof(xviz::Vec2f));
+
+        record.pointCount = static_cast<uint32_t>(cloud.points.size());
+        record.pointsOffset = AppendBlock(&m_buffer, cloud.points.data(),
+                                          cloud.points.size() * sizeof(xviz::PointXYZ));
+        m_buffer.resize(AlignUp(m_buffer.size()));
+        record.recordSize = m_buffer.size();
+        std::memcpy(m_buffer.data(), &record, sizeof(record));
+
+        m_out.write(reinterpret_cast<const char *>(m_buffer.data()),
+                    static_cast<std::streamsize>(m_buffer.size()));
+        if (!m_out.good())
+        {
+            return false;
+        }
+        m_index.push_back({m_offset, record.recordSize});
+        m_offset += record.recordSize;
+        return true;
+    }
+
+    bool ScenarioLogWriter::Close()
+    {
+        if (!m_out.is_open())
+        {
+            return true;
+        }
+        m_out.write(reinterpret_cast<const char *>(m_index.data()),
+                    static_cast<std::streamsize>(m_index.size() * sizeof(ScenarioIndexEntry)));
+
+        ScenarioLogHeader header = {};
+        std::memcpy(header.magic, kScenarioLogMagic, sizeof(header.magic));
+        header.version = kScenarioLogVersion;
+        header.recordCount = static_cast<uint32_t>(m_index.size());
+        header.indexOffset = m_offset;
+        m_out.seekp(0);
+        m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        const bool ok = m_out.good();
+        m_out.close();
+        return ok;
+    }
+
+    bool ScenarioLogReader::Open(const std::string &path)
+    {
+        Close();
+        if (!m_file.Open(path) || m_file.Size() < sizeof(ScenarioLogHeader))
+        {
+            Close();
+            return false;
+        }
+        const auto *header = reinterpret_cast<const ScenarioLogHeader *>(m_file.Data());
+        const uint64_t index_bytes = static_cast<uint64_t>(header->recordCount) * sizeof(ScenarioIndexEntry);
+        if (std::memcmp(header->magic, kScenarioLogMagic, sizeof(header->magic)) != 0 ||
+            header->version != kScenarioLogVersion ||
+            header->indexOffset % kAlignment != 0 ||
+            header->indexOffset > m_file.Size() ||
+            index_bytes > m_file.Size() - header->indexOffset)
+        {
+            Close();
+            return false;
+        }
+        m_index = Span<ScenarioIndexEntry>(
+            reinterpret_cast<const ScenarioIndexEntry *>(m_file.Data() + header->indexOffset),
+            header->recordCount);
+        for (const auto &entry : m_index)
+        {
+            if (entry.offset % kAlignment != 0 || entry.size < sizeof(ScenarioRecord) ||
+                entry.offset > header->indexOffset || entry.size > header->indexOffset - entry.offset)
+            {
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ScenarioLogReader::Close()
+    {
+        m_index = Span<ScenarioIndexEntry>();
+        m_file.Close();
+    }
+
+    bool ScenarioLogReader::Get(const size_t i, ScenarioView *view) const
+    {
+        if (i >= m_index.size())
+        {
+            return false;
+        }
+        const uint8_t *base = m_file.Data() + m_index[i].offset;
+        const auto *record = reinterpret_cast<const ScenarioRecord *>(base);
+        const uint64_t size = m_index[i].size;
+        const uint64_t cells = static_cast<uint64_t>(record->map.width) * record->map.height;
+        if (record->recordSize != size ||
+            !InRecord(record->map.dataOffset, cells, size) ||
+            !InRecord(record->polygonOffsetsOffset, (record->polygonCount + 1ull) * sizeof(uint32_t), size) ||
+            !InRecord(record->verticesOffset, record->vertexCount * sizeof(xviz::Vec2f), size) ||
+            !InRecord(record->pointsOffset, record->pointCount * sizeof(xviz::PointXYZ), size) ||
+            !ValidOffsets(reinterpret_cast<const uint32_t *>(base + record->polygonOffsetsOffset),
+                          record->polygonCount, record->vertexCount))
+        {
+            return false;
+        }
+
+        view->start = FromRecord(record->start);
+        view->target = FromRecord(record->target);
+
+        view->map.header.seq = record->start.seq;
+        view->map.header.timeStamp = record->start.timeStamp;
+        view->map.m_data = const_cast<unsigned char *>(base + record->map.dataOffset);
+        view->map.m_dataPtr = 0;
+        view->map.m_res = record->map.res;
+        view->map.m_origin = xviz::Vec2f(record->map.originX, record->map.originY);
+        view->map.m_size = xviz::Vec2f(static_cast<float>(record->map.width),
+                                       static_cast<float>(record->map.height));
+        view->map.m_originYaw = record->map.originYaw;
+        view->map.m_usePtr = true;
+
+        view->polygonOffsets = Span<uint32_t>(
+            reinterpret_cast<const uint32_t *>(base + record->polygonOffsetsOffset),
+            record->polygonCount + 1);
+        view->vertices = Span<xviz::Vec2f>(
+            reinterpret_cast<const xviz::Vec2f *>(base + record->verticesOffset), record->vertexCount);
+        view->points = Span<xviz::PointXYZ>(
+            reinterpret_cast<const xviz::PointXYZ *>(base + record->pointsOffset), record->pointCount);
+        return true;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,155 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-10 21:20:44
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-10 21:20:44
+ */
+
+#ifndef __SCENARIO_LOG_H__
+#define __SCENARIO_LOG_H__
+
+#include "data_types.h"
+#include "common/mapped_file.h"
+#include "common/span.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    // 场景日志文件布局(主机字节序):
+    //   ScenarioLogHeader | record 0 | record 1 | ... | ScenarioIndexEntry[recordCount]
+    // 每条 record 以 ScenarioRecord 开头, 其后依次为栅格数据, 多边形偏移表, 顶点, 点云,
+    // 各段按 8 字节对齐, 偏移量均相对于 record 起始位置
+
+    constexpr char kScenarioLogMagic[8] = {'A', 'P', 'P', 'S', 'C', 'N', 'L', 'G'};
+    constexpr uint32_t kScenarioLogVersion = 1;
+
+    struct ScenarioLogHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordCount;
+        uint64_t indexOffset;
+        uint64_t reserved;
+    };
+
+    struct PoseRecord
+    {
+        float x;
+        float y;
+        float yaw;
+        uint32_t seq;
+        double timeStamp;
+    };
+
+    struct GridMapRecord
+    {
+        float res;
+        float originX;
+        float originY;
+        float originYaw;
+        uint32_t width;
+        uint32_t height;
+        uint64_t dataOffset;
+    };
+
+    struct ScenarioRecord
+    {
+        PoseRecord start;
+        PoseRecord target;
+        GridMapRecord map;
+        uint32_t polygonCount;
+        uint32_t vertexCount;
+        uint64_t polygonOffsetsOffset;
+        uint64_t verticesOffset;
+        uint32_t pointCount;
+        uint32_t reserved;
+        uint64_t pointsOffset;
+        uint64_t recordSize;
+    };
+
+    struct ScenarioIndexEntry
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(ScenarioLogHeader) == 32, "unexpected ScenarioLogHeader layout");
+    static_assert(sizeof(PoseRecord) == 24, "unexpected PoseRecord layout");
+    static_assert(sizeof(GridMapRecord) == 32, "unexpected GridMapRecord layout");
+    static_assert(sizeof(ScenarioRecord) == 128, "unexpected ScenarioRecord layout");
+    static_assert(sizeof(ScenarioIndexEntry) == 16, "unexpected ScenarioIndexEntry layout");
+    // 顶点与点云直接以 xviz 类型视图返回, 要求其为紧凑的 float 结构
+    static_assert(std::is_standard_layout<xviz::Vec2f>::value && sizeof(xviz::Vec2f) == 2 * sizeof(float),
+                  "xviz::Vec2f must be two packed floats");
+    static_assert(std::is_standard_layout<xviz::PointXYZ>::value && sizeof(xviz::PointXYZ) == 3 * sizeof(float),
+                  "xviz::PointXYZ must be three packed floats");
+
+    /// @brief 回放出的单个场景, 所有数组均直接指向映射内存
+    struct ScenarioView
+    {
+        xviz::Pose start;
+        xviz::Pose target;
+        /// m_data 指向只读映射内存, 使用方不得写入
+        xviz::GridMap map;
+        Span<uint32_t> polygonOffsets;
+        Span<xviz::Vec2f> vertices;
+        Span<xviz::PointXYZ> points;
+
+        size_t PolygonCount() const { return polygonOffsets.empty() ? 0 : polygonOffsets.size() - 1; }
+
+        Span<xviz::Vec2f> Polygon(const size_t i) const
+        {
+            return Span<xviz::Vec2f>(vertices.data() + polygonOffsets[i],
+                                     polygonOffsets[i + 1] - polygonOffsets[i]);
+        }
+    };
+
+    class ScenarioLogWriter
+    {
+    public:
+        ScenarioLogWriter() = default;
+        ~ScenarioLogWriter();
+
+        bool Open(const std::string &path);
+
+        bool Append(const xviz::Pose &start, const xviz::Pose &target,
+                    const xviz::GridMap &map, const xviz::Polygons2f &polygons,
+                    const xviz::PointCloud3f &cloud);
+
+        /// @brief 写入索引并回填文件头, 析构时自动调用
+        bool Close();
+
+        size_t RecordCount() const { return m_index.size(); }
+
+    private:
+        std::ofstream m_out;
+        uint64_t m_offset = 0;
+        std::vector<ScenarioIndexEntry> m_index;
+        std::vector<uint8_t> m_buffer;
+    };
+
+    class ScenarioLogReader
+    {
+    public:
+        /// @brief 映射文件并校验文件头与索引, 不读取 record 内容
+        bool Open(const std::string &path);
+
+        void Close();
+
+        size_t Size() const { return m_index.size(); }
+
+        /// @brief O(1) 获取第 i 个场景的零拷贝视图
+        bool Get(const size_t i, ScenarioView *view) const;
+
+    private:
+        MappedFile m_file;
+        Span<ScenarioIndexEntry> m_index;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __SCENARIO_LOG_H__ */
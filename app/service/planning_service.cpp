@@ -0,0 +1,194 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 10:05:33
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 10:05:33
+ */
+#include "planning_service.h"
+#include "common/profile_publisher.h"
+#include <chrono>
+#include <cmath>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        /// 空闲时单次等待的最长时间; 新请求与 Stop 都会立即唤醒工作线程, 超时只是兜底
+        constexpr auto kIdleWait = std::chrono::milliseconds(100);
+    }
+
+    PlanningService::PlanningService(const PlanningServiceConfig &config)
+        : m_config(config), m_pipeline(config.planner), m_pathSimplifier(config.pathTolerance)
+    {
+    }
+
+    PlanningService::~PlanningService() { Stop(); }
+
+    void PlanningService::SetMap(const xviz::GridMap &map, const ObstacleView &obstacles)
+    {
+        m_pipeline.SetMap(map, obstacles);
+    }
+
+    bool PlanningService::Start()
+    {
+        if (m_running)
+        {
+            return true;
+        }
+        // 只映射文件头, 块在截取窗口时才调入
+        if (!m_config.tiledMapPath.empty() && !m_tiledMap.Open(m_config.tiledMapPath, m_config.tiledMap))
+        {
+            return false;
+        }
+        if (!m_bridge.Init(m_config.pubConnect, m_config.subConnect))
+        {
+            return false;
+        }
+        m_bridge.SetInitPoseFunc([this](const xviz::Pose &pose) { OnInitPose(pose); });
+        m_bridge.SetTargetPoseFunc([this](const xviz::Pose &pose) { OnTargetPose(pose); });
+        m_running = true;
+        m_worker = std::thread(&PlanningService::WorkerLoop, this);
+        m_bridge.Run();
+        return true;
+    }
+
+    void PlanningService::Stop()
+    {
+        if (!m_running.exchange(false))
+        {
+            return;
+        }
+        // 先停下工作线程再关闭 bridge, 避免规划恰好完成时向已关闭的 bridge 发布
+        m_cancel.Cancel();
+        m_requests.Interrupt();
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+        m_bridge.Shutdown();
+    }
+
+    PlanningServiceStats PlanningService::Stats() const
+    {
+        PlanningServiceStats stats;
+        stats.requests = m_requests.Posted();
+        stats.superseded = m_requests.Superseded();
+        stats.cancelled = m_cancelled.load();
+        stats.published = m_published.load();
+        stats.failed = m_failed.load();
+        stats.mapUnavailable = m_mapUnavailable.load();
+        return stats;
+    }
+
+    void PlanningService::OnInitPose(const xviz::Pose &pose)
+    {
+        m_pending.start = pose;
+        m_hasStart = true;
+        Submit();
+    }
+
+    void PlanningService::OnTargetPose(const xviz::Pose &pose)
+    {
+        m_pending.goal = pose;
+        m_hasGoal = true;
+        Submit();
+    }
+
+    void PlanningService::Submit()
+    {
+        if (!m_hasStart || !m_hasGoal)
+        {
+            return;
+        }
+        // 先使进行中的规划失效, 再投递新请求; 请求携带新代数, 工作线程据此签发标记
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        m_pending.generation = m_cancel.Cancel();
+        m_requests.Post(m_pending);
+    }
+
+    void PlanningService::WorkerLoop()
+    {
+        PlanRequest request;
+        while (m_running)
+        {
+            if (!m_requests.WaitFor(kIdleWait, &request))
+            {
+                continue;
+            }
+            const CancelToken token = m_cancel.TokenFor(request.generation);
+            if (!UpdateWindow(request))
+            {
+                // 截不到窗口时不能沿用旧窗口规划, 起点或目标可能在其外
+                ++m_mapUnavailable;
+                continue;
+            }
+            const PlanResult result =
+                m_config.budgetMs > 0.0
+                    ? m_pipeline.PlanAnytime(request.start, request.goal,
+                                             std::chrono::steady_clock::now() +
+                                                 std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                     std::chrono::duration<double, std::milli>(m_config.budgetMs)),
+                                             token)
+                    : m_pipeline.Plan(request.start, request.goal, token);
+            // 每个规划周期汇总一次, 被取消的周期随结果一起丢弃, 不计入下一帧
+            const ProfileFrame frame = Profiler::Instance().Collect();
+            if (result.status == PlanStatus::CANCELLED || token.IsCancelled())
+            {
+                // 更新的请求已在信箱中, 丢弃本次结果
+                ++m_cancelled;
+                continue;
+            }
+            if (!result.Success())
+            {
+                PublishProfileFrame(&m_bridge, frame);
+                ++m_failed;
+                continue;
+            }
+            const xviz::Path2f path = result.path.ToPath2f();
+            const xviz::Path2f published = m_pathSimplifier.Simplify(path);
+            {
+                // 规划结束后到达的请求也使本次结果过期; 持锁期间新请求无法提交
+                std::lock_guard<std::mutex> lock(m_publishMutex);
+                if (token.IsCancelled())
+                {
+                    ++m_cancelled;
+                    continue;
+                }
+                m_bridge.PosePub(m_config.startTopic, request.start);
+                m_bridge.PosePub(m_config.goalTopic, request.goal);
+                m_bridge.PathPub(m_config.pathTopic, published);
+            }
+            PublishProfileFrame(&m_bridge, frame);
+            ++m_published;
+            // 车辆将沿路径行驶, 在后台调入沿途窗口会用到的块; 用化简前的点, 长直线段上也不漏块
+            m_tiledMap.Prefetch(path.points, 0.5f * m_config.windowSize);
+        }
+    }
+
+    bool PlanningService::UpdateWindow(const PlanRequest &request)
+    {
+        if (!m_tiledMap.IsOpen())
+        {
+            return true;
+        }
+        const float reach = 0.25f * m_config.windowSize;
+        const auto inside = [this, reach](const xviz::Pose &pose) {
+            return std::fabs(pose.x - m_windowCenter.x) <= reach && std::fabs(pose.y - m_windowCenter.y) <= reach;
+        };
+        if (m_hasWindow && inside(request.start) && inside(request.goal))
+        {
+            return true;
+        }
+        const xviz::Vec2f center(0.5f * (request.start.x + request.goal.x), 0.5f * (request.start.y + request.goal.y));
+        xviz::GridMap window;
+        if (!m_tiledMap.Window(center.x, center.y, m_config.windowSize, &window, &m_window))
+        {
+            return false;
+        }
+        m_pipeline.SetMap(window);
+        m_windowCenter = center;
+        m_hasWindow = true;
+        return true;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,133 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-21 09:48:17
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-21 09:48:17
+ */
+
+#ifndef __PLANNING_SERVICE_H__
+#define __PLANNING_SERVICE_H__
+
+#include "common/cancel_token.h"
+#include "common/latest_mailbox.h"
+#include "map/tiled_map.h"
+#include "planner/planning_pipeline.h"
+#include "xvizMsgBridge.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace auto_parking_planning
+{
+    struct PlanningServiceConfig
+    {
+        std::string pubConnect = "tcp://127.0.0.1:8888";
+        std::string subConnect = "tcp://127.0.0.1:8889";
+        std::string pathTopic = "planned_path";
+        std::string startTopic = "plan_start";
+        std::string goalTopic = "plan_goal";
+        PlannerConfig planner;
+        /// 大于 0 时每次请求以限时模式规划, 单位毫秒
+        double budgetMs = 0.0;
+        /// 非空时从分块地图文件按需截取规划窗口, 代替 SetMap 设置的地图
+        std::string tiledMapPath;
+        TiledMapConfig tiledMap;
+        /// 规划窗口边长, 单位米; 起点或目标离窗口中心超过边长的四分之一时重新截取
+        float windowSize = 60.0f;
+        /// 发布路径的 Douglas-Peucker 化简容差, 单位米, 0 为发布全部路径点
+        float pathTolerance = 0.02f;
+    };
+
+    struct PlanningServiceStats
+    {
+        /// 收到的完整请求数(起点与目标都已知后, 每次位姿更新计一次)
+        uint64_t requests = 0;
+        /// 未开始规划即被更新请求覆盖的次数
+        uint64_t superseded = 0;
+        /// 规划途中被更新请求取消的次数
+        uint64_t cancelled = 0;
+        /// 已发布路径的规划次数
+        uint64_t published = 0;
+        /// 完成但未找到路径的规划次数
+        uint64_t failed = 0;
+        /// 分块地图截不出包含起点与目标的窗口, 未规划即放弃的请求数
+        uint64_t mapUnavailable = 0;
+    };
+
+    /// @brief 规划服务: 持有 bridge, 接收起点与目标位姿, 在工作线程上规划并发布路径.
+    /// 新请求到达时在接收线程上立即取消进行中的规划, 过期结果不会发布
+    class PlanningService
+    {
+    public:
+        explicit PlanningService(const PlanningServiceConfig &config = PlanningServiceConfig());
+
+        ~PlanningService();
+
+        /// @brief 设置地图, 须在 Start 之前调用; 引用的数据在服务运行期间须保持有效.
+        /// 配置了分块地图时不使用
+        void SetMap(const xviz::GridMap &map, const ObstacleView &obstacles = ObstacleView());
+
+        bool Start();
+
+        void Stop();
+
+        PlanningServiceStats Stats() const;
+
+        xviz::XvizMsgBridge &Bridge() { return m_bridge; }
+
+    private:
+        struct PlanRequest
+        {
+            xviz::Pose start;
+            xviz::Pose goal;
+            /// 提交请求时的取消代数
+            uint64_t generation = 0;
+        };
+
+        /// 以下三个函数只在 bridge 接收线程上调用
+        void OnInitPose(const xviz::Pose &pose);
+
+        void OnTargetPose(const xviz::Pose &pose);
+
+        void Submit();
+
+        void WorkerLoop();
+
+        /// @brief 工作线程调用, 需要时以起点与目标的中点为中心重新截取窗口.
+        /// 截取失败时返回 false, 此时旧窗口不一定包含起点与目标, 不可用于规划
+        bool UpdateWindow(const PlanRequest &request);
+
+    private:
+        PlanningServiceConfig m_config;
+        xviz::XvizMsgBridge m_bridge;
+        PlanningPipeline m_pipeline;
+
+        /// 以下五个成员只在工作线程上使用(打开文件在 Start 中完成)
+        TiledMap m_tiledMap;
+        std::vector<unsigned char> m_window;
+        xviz::Vec2f m_windowCenter;
+        bool m_hasWindow = false;
+        PolylineSimplifier m_pathSimplifier;
+
+        LatestMailbox<PlanRequest> m_requests;
+        CancelSource m_cancel;
+        /// 提交新请求与发布结果互斥, 发布前检查取消标记与发布本身对新请求是原子的
+        std::mutex m_publishMutex;
+        /// 接收线程独占, 记录最近一次的起点与目标
+        PlanRequest m_pending;
+        bool m_hasStart = false;
+        bool m_hasGoal = false;
+
+        std::thread m_worker;
+        std::atomic<bool> m_running{false};
+        std::atomic<uint64_t> m_cancelled{0};
+        std::atomic<uint64_t> m_published{0};
+        std::atomic<uint64_t> m_failed{0};
+        std::atomic<uint64_t> m_mapUnavailable{0};
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __PLANNING_SERVICE_H__ */
@@ -0,0 +1,284 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 15:20:37
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 15:20:37
+ */
+
+#ifndef __BENCH_UTILS_H__
+#define __BENCH_UTILS_H__
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace auto_parking_planning
+{
+    /// @brief 最近秩百分位, values 会被排序
+    inline double Percentile(std::vector<double> *values, const double p)
+    {
+        if (values->empty())
+        {
+            return 0.0;
+        }
+        std::sort(values->begin(), values->end());
+        const double rank = std::ceil(p / 100.0 * values->size());
+        const size_t index = static_cast<size_t>(std::max(1.0, rank)) - 1;
+        return (*values)[std::min(index, values->size() - 1)];
+    }
+
+    /// @brief 进程峰值常驻内存, 单位字节
+    inline size_t PeakResidentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    /// @brief 简单的 JSON 输出器, 仅支持对象嵌套与数值/字符串字段
+    class JsonWriter
+    {
+    public:
+        void BeginObject(const std::string &key = std::string())
+        {
+            Separator();
+            Key(key);
+            m_out << "{";
+            m_first.push_back(true);
+        }
+
+        void EndObject()
+        {
+            m_first.pop_back();
+            m_out << "\n" << Indent() << "}";
+        }
+
+        void Number(const std::string &key, const double value)
+        {
+            Separator();
+            Key(key);
+            if (std::isfinite(value))
+            {
+                m_out << value;
+            }
+            else
+            {
+                m_out << "null";
+            }
+        }
+
+        void String(const std::string &key, const std::string &value)
+        {
+            Separator();
+            Key(key);
+            m_out << "\"" << value << "\"";
+        }
+
+        std::string Str() const { return m_out.str() + "\n"; }
+
+    private:
+        void Separator()
+        {
+            if (m_first.empty())
+            {
+                return;
+            }
+            if (!m_first.back())
+            {
+                m_out << ",";
+            }
+            m_first.back() = false;
+            m_out << "\n" << Indent();
+        }
+
+        void Key(const std::string &key)
+        {
+            if (!key.empty())
+            {
+                m_out << "\"" << key << "\": ";
+            }
+        }
+
+        std::string Indent() const { return std::string(m_first.size() * 2, ' '); }
+
+    private:
+        std::ostringstream m_out;
+        std::vector<bool> m_first;
+    };
+
+    /// @brief 将 JSON 对象中的数值字段展平为 "a.b.c" -> value, 用于与基线比较
+    class FlatJsonReader
+    {
+    public:
+        bool Parse(const std::string &text, std::map<std::string, double> *values)
+        {
+            m_text = &text;
+            m_pos = 0;
+            m_values = values;
+            SkipSpace();
+            return ParseValue(std::string());
+        }
+
+        bool ParseFile(const std::string &path, std::map<std::string, double> *values)
+        {
+            std::ifstream in(path);
+            if (!in.is_open())
+            {
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << in.rdbuf();
+            const std::string text = buffer.str();
+            return Parse(text, values);
+        }
+
+    private:
+        void SkipSpace()
+        {
+            while (m_pos < m_text->size() && std::isspace(static_cast<unsigned char>((*m_text)[m_pos])))
+            {
+                ++m_pos;
+            }
+        }
+
+        bool Expect(const char c)
+        {
+            SkipSpace();
+            if (m_pos < m_text->size() && (*m_text)[m_pos] == c)
+            {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+
+        bool ParseString(std::string *out)
+        {
+            if (!Expect('"'))
+            {
+                return false;
+            }
+            out->clear();
+            while (m_pos < m_text->size() && (*m_text)[m_pos] != '"')
+            {
+                if ((*m_text)[m_pos] == '\\')
+                {
+                    ++m_pos;
+                }
+                if (m_pos < m_text->size())
+                {
+                    out->push_back((*m_text)[m_pos++]);
+                }
+            }
+            return Expect('"');
+        }
+
+        bool ParseValue(const std::string &path)
+        {
+            SkipSpace();
+            if (m_pos >= m_text->size())
+            {
+                return false;
+            }
+            const char c = (*m_text)[m_pos];
+            if (c == '{')
+            {
+                ++m_pos;
+                if (Expect('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    std::string key;
+                    if (!ParseString(&key) || !Expect(':') ||
+                        !ParseValue(path.empty() ? key : path + "." + key))
+                    {
+                        return false;
+                    }
+                } while (Expect(','));
+                return Expect('}');
+            }
+            if (c == '[')
+            {
+                ++m_pos;
+                if (Expect(']'))
+                {
+                    return true;
+                }
+                int index = 0;
+                do
+                {
+                    if (!ParseValue(path + "." + std::to_string(index++)))
+                    {
+                        return false;
+                    }
+                } while (Expect(','));
+                return Expect(']');
+            }
+            if (c == '"')
+            {
+                std::string ignored;
+                return ParseString(&ignored);
+            }
+            const size_t begin = m_pos;
+            while (m_pos < m_text->size() && std::string(",}] \t\r\n").find((*m_text)[m_pos]) == std::string::npos)
+            {
+                ++m_pos;
+            }
+            const std::string token = m_text->substr(begin, m_pos - begin);
+            if (token == "true" || token == "false" || token == "null")
+            {
+                return true;
+            }
+            char *end = nullptr;
+            const double value = std::strtod(token.c_str(), &end);
+            if (end == token.c_str())
+            {
+                return false;
+            }
+            (*m_values)[path] = value;
+            return true;
+        }
+
+    private:
+        const std::string *m_text = nullptr;
+        size_t m_pos = 0;
+        std::map<std::string, double> *m_values = nullptr;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __BENCH_UTILS_H__ */
@@ -0,0 +1,572 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 16:02:18
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 16:02:18
+ */
+#include "bench_utils.h"
+#include "scenario_generator.h"
+#include "common/profiler.h"
+#include "common/task_scheduler.h"
+#include "planner/bucket_queue.h"
+#include "planner/planning_pipeline.h"
+#include "planner/state_table.h"
+#include "record/scenario_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace auto_parking_planning;
+
+namespace
+{
+    struct BenchOptions
+    {
+        int countPerCategory = 25;
+        uint32_t seed = 1;
+        int repeat = 1;
+        double tolerance = 0.15;
+        string logPath;
+        string recordPath;
+        string outputPath;
+        string baselinePath;
+        string rsTablePath;
+        bool containers = false;
+        bool scalarRollout = false;
+        bool lattice = true;
+        bool geometric = true;
+        bool shortcut = true;
+        bool coarseToFine = false;
+        /// 大于 0 时以限时模式规划
+        double budgetMs = 0.0;
+    };
+
+    struct CategoryStats
+    {
+        int runs = 0;
+        int success = 0;
+        int geometric = 0;
+        vector<double> latencyMs;
+        double searchMs = 0.0;
+        uint64_t expansions = 0;
+        size_t peakSearchMemory = 0;
+        /// 搜索得到的路径的启发权重之和, 解析式机动不计入
+        double weightSum = 0.0;
+        int weighted = 0;
+        /// 成功路径的长度、换挡次数与捷径后处理耗时之和
+        double pathLength = 0.0;
+        int gearSwitches = 0;
+        double shortcutMs = 0.0;
+
+        void Add(const PlanResult &result, const double latency_ms)
+        {
+            ++runs;
+            success += result.Success() ? 1 : 0;
+            geometric += result.stats.geometric ? 1 : 0;
+            latencyMs.push_back(latency_ms);
+            searchMs += result.stats.searchMs;
+            expansions += result.stats.expansions;
+            peakSearchMemory = max(peakSearchMemory, result.stats.searchMemory);
+            if (result.Success())
+            {
+                pathLength += result.path.Length();
+                gearSwitches += result.path.GearSwitches();
+            }
+            shortcutMs += result.stats.shortcutMs;
+            if (result.Success() && !result.stats.geometric)
+            {
+                weightSum += result.heuristicWeight;
+                ++weighted;
+            }
+        }
+
+        void Merge(const CategoryStats &other)
+        {
+            runs += other.runs;
+            success += other.success;
+            geometric += other.geometric;
+            latencyMs.insert(latencyMs.end(), other.latencyMs.begin(), other.latencyMs.end());
+            searchMs += other.searchMs;
+            expansions += other.expansions;
+            peakSearchMemory = max(peakSearchMemory, other.peakSearchMemory);
+            weightSum += other.weightSum;
+            weighted += other.weighted;
+            pathLength += other.pathLength;
+            gearSwitches += other.gearSwitches;
+            shortcutMs += other.shortcutMs;
+        }
+
+        double ExpansionsPerSecond() const
+        {
+            return searchMs > 0.0 ? expansions / (searchMs * 1e-3) : 0.0;
+        }
+    };
+
+    /// 回放搜索记录, 比较内部容器与标准库容器
+    struct ContainerStats
+    {
+        typedef pair<float, uint32_t> QueueItem;
+
+        SearchRecorder recorder;
+        unordered_map<uint64_t, uint32_t> stdStates;
+        StateTable states;
+        uint64_t stateAccesses = 0;
+        double stdStatesMs = 0.0;
+        double statesMs = 0.0;
+
+        vector<float> stdOpenKeys;
+        BucketQueue open;
+        uint64_t openAccesses = 0;
+        double stdOpenMs = 0.0;
+        double openMs = 0.0;
+
+        /// 两种容器结果一致时为 0
+        uint64_t checksum = 0;
+
+        void Replay()
+        {
+            ReplayStates();
+            ReplayOpen();
+        }
+
+        void ReplayStates()
+        {
+            const auto &keys = recorder.stateKeys;
+            stateAccesses += keys.size();
+
+            auto t0 = chrono::steady_clock::now();
+            stdStates.clear();
+            uint32_t next = 0;
+            for (const uint64_t key : keys)
+            {
+                uint32_t &value = stdStates.emplace(key, kInvalidIndex).first->second;
+                value = value == kInvalidIndex ? next++ : value;
+                checksum += value;
+            }
+            stdStatesMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+            t0 = chrono::steady_clock::now();
+            states.Clear();
+            next = 0;
+            for (const uint64_t key : keys)
+            {
+                uint32_t &value = *states.Slot(key);
+                value = value == kInvalidIndex ? next++ : value;
+                checksum -= value;
+            }
+            statesMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        }
+
+        /// std::priority_queue 没有降低代价操作, 与原先的搜索一样以重复项加惰性删除模拟
+        void ReplayOpen()
+        {
+            const auto &accesses = recorder.openAccesses;
+            openAccesses += accesses.size();
+            uint32_t max_handle = 0;
+            for (const auto &access : accesses)
+            {
+                max_handle = max(max_handle, access.handle);
+            }
+
+            auto t0 = chrono::steady_clock::now();
+            priority_queue<QueueItem, vector<QueueItem>, greater<QueueItem>> std_open;
+            stdOpenKeys.assign(max_handle + 1, -1.0f);
+            for (const auto &access : accesses)
+            {
+                if (access.op == SearchRecorder::OpenOp::POP)
+                {
+                    while (std_open.top().first != stdOpenKeys[std_open.top().second])
+                    {
+                        std_open.pop();
+                    }
+                    stdOpenKeys[std_open.top().second] = -1.0f;
+                    std_open.pop();
+                }
+                else
+                {
+                    stdOpenKeys[access.handle] = access.key;
+                    std_open.push(QueueItem(access.key, access.handle));
+                }
+            }
+            stdOpenMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+            t0 = chrono::steady_clock::now();
+            open.Clear();
+            for (const auto &access : accesses)
+            {
+                switch (access.op)
+                {
+                case SearchRecorder::OpenOp::PUSH:
+                    open.Push(access.handle, access.key);
+                    break;
+                case SearchRecorder::OpenOp::UPDATE:
+                    open.Update(access.handle, access.key);
+                    break;
+                case SearchRecorder::OpenOp::POP:
+                    open.Pop();
+                    break;
+                }
+            }
+            openMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        }
+
+        void Write(JsonWriter *json) const
+        {
+            if (checksum != 0)
+            {
+                fprintf(stderr, "container replay results differ\n");
+            }
+            json->BeginObject("containers");
+            json->BeginObject("closed_set");
+            json->Number("accesses", static_cast<double>(stateAccesses));
+            json->Number("unordered_map_ms", stdStatesMs);
+            json->Number("state_table_ms", statesMs);
+            json->Number("speedup", statesMs > 0.0 ? stdStatesMs / statesMs : 0.0);
+            json->EndObject();
+            json->BeginObject("open_list");
+            json->Number("accesses", static_cast<double>(openAccesses));
+            json->Number("priority_queue_ms", stdOpenMs);
+            json->Number("bucket_queue_ms", openMs);
+            json->Number("speedup", openMs > 0.0 ? stdOpenMs / openMs : 0.0);
+            json->EndObject();
+            json->EndObject();
+        }
+    };
+
+    void PrintUsage()
+    {
+        cerr << "usage: scenario_bench [options]\n"
+             << "  --count N        scenarios generated per category (default 25)\n"
+             << "  --seed S         generator seed (default 1)\n"
+             << "  --repeat R       plans per scenario (default 1)\n"
+             << "  --log FILE       replay scenarios from a recorded scenario log\n"
+             << "  --record FILE    write the generated scenarios to a scenario log\n"
+             << "  --output FILE    write JSON results to FILE instead of stdout\n"
+             << "  --baseline FILE  compare against a previous JSON result\n"
+             << "  --tolerance T    allowed relative regression (default 0.15)\n"
+             << "  --rs-table FILE  use a precomputed Reeds-Shepp heuristic table\n"
+             << "  --containers     replay each search against standard containers\n"
+             << "  --scalar-rollout expand nodes with the scalar integrator instead of batch rollouts\n"
+             << "  --runtime-primitives integrate motion primitives at runtime instead of the constexpr lattice\n"
+             << "  --no-geometric   always run the search, skipping the analytic parking maneuvers\n"
+             << "  --no-shortcut    skip the shortcut post-processing of search paths\n"
+             << "  --coarse-to-fine collision checks on the occupancy pyramid, coarse levels first\n"
+             << "  --budget MS      anytime planning with a per-plan deadline of MS milliseconds\n";
+    }
+
+    bool ParseOptions(int argc, char const *argv[], BenchOptions *options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--count" && has_value)
+                options->countPerCategory = atoi(argv[++i]);
+            else if (arg == "--seed" && has_value)
+                options->seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--repeat" && has_value)
+                options->repeat = max(1, atoi(argv[++i]));
+            else if (arg == "--rs-table" && has_value)
+                options->rsTablePath = argv[++i];
+            else if (arg == "--containers")
+                options->containers = true;
+            else if (arg == "--scalar-rollout")
+                options->scalarRollout = true;
+            else if (arg == "--runtime-primitives")
+                options->lattice = false;
+            else if (arg == "--no-geometric")
+                options->geometric = false;
+            else if (arg == "--no-shortcut")
+                options->shortcut = false;
+            else if (arg == "--coarse-to-fine")
+                options->coarseToFine = true;
+            else if (arg == "--budget" && has_value)
+                options->budgetMs = atof(argv[++i]);
+            else if (arg == "--tolerance" && has_value)
+                options->tolerance = atof(argv[++i]);
+            else if (arg == "--log" && has_value)
+                options->logPath = argv[++i];
+            else if (arg == "--record" && has_value)
+                options->recordPath = argv[++i];
+            else if (arg == "--output" && has_value)
+                options->outputPath = argv[++i];
+            else if (arg == "--baseline" && has_value)
+                options->baselinePath = argv[++i];
+            else
+                return false;
+        }
+        return true;
+    }
+
+    void RunScenario(PlanningPipeline *pipeline, const xviz::GridMap &map, const ObstacleView &obstacles,
+                     const xviz::Pose &start, const xviz::Pose &target, const int repeat, const double budget_ms,
+                     CategoryStats *stats, ContainerStats *containers)
+    {
+        for (int r = 0; r < repeat; ++r)
+        {
+            const auto t0 = chrono::steady_clock::now();
+            pipeline->SetMap(map, obstacles);
+            const auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                                    chrono::duration<double, milli>(budget_ms));
+            const PlanResult result =
+                budget_ms > 0.0 ? pipeline->PlanAnytime(start, target, deadline) : pipeline->Plan(start, target);
+            const double latency = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            stats->Add(result, latency);
+            if (containers != nullptr)
+            {
+                containers->Replay();
+            }
+        }
+    }
+
+    void WriteStats(JsonWriter *json, const string &key, CategoryStats stats)
+    {
+        json->BeginObject(key);
+        json->Number("scenarios", stats.runs);
+        json->Number("success_rate", stats.runs > 0 ? static_cast<double>(stats.success) / stats.runs : 0.0);
+        json->Number("geometric_rate", stats.runs > 0 ? static_cast<double>(stats.geometric) / stats.runs : 0.0);
+        json->BeginObject("latency_ms");
+        double sum = 0.0;
+        for (const double v : stats.latencyMs)
+        {
+            sum += v;
+        }
+        json->Number("mean", stats.latencyMs.empty() ? 0.0 : sum / stats.latencyMs.size());
+        json->Number("p50", Percentile(&stats.latencyMs, 50.0));
+        json->Number("p90", Percentile(&stats.latencyMs, 90.0));
+        json->Number("p99", Percentile(&stats.latencyMs, 99.0));
+        json->Number("max", stats.latencyMs.empty() ? 0.0 : stats.latencyMs.back());
+        json->EndObject();
+        json->Number("expansions", static_cast<double>(stats.expansions));
+        json->Number("expansions_per_second", stats.ExpansionsPerSecond());
+        json->Number("peak_search_memory_mb", stats.peakSearchMemory / (1024.0 * 1024.0));
+        json->Number("mean_heuristic_weight", stats.weighted > 0 ? stats.weightSum / stats.weighted : 0.0);
+        json->Number("mean_path_length", stats.success > 0 ? stats.pathLength / stats.success : 0.0);
+        json->Number("mean_gear_switches", stats.success > 0 ? static_cast<double>(stats.gearSwitches) / stats.success : 0.0);
+        json->Number("mean_shortcut_ms", stats.runs > 0 ? stats.shortcutMs / stats.runs : 0.0);
+        json->EndObject();
+    }
+
+    /// 返回回归项数量
+    int CompareWithBaseline(const map<string, double> &current, const map<string, double> &baseline,
+                            const double tolerance)
+    {
+        struct Metric
+        {
+            const char *key;
+            bool higherIsWorse;
+        };
+        const Metric metrics[] = {
+            {"overall.latency_ms.p50", true},
+            {"overall.latency_ms.p90", true},
+            {"overall.latency_ms.p99", true},
+            {"overall.expansions_per_second", false},
+            {"overall.success_rate", false},
+        };
+        int regressions = 0;
+        for (const auto &metric : metrics)
+        {
+            const auto cur = current.find(metric.key);
+            const auto base = baseline.find(metric.key);
+            if (cur == current.end() || base == baseline.end())
+            {
+                continue;
+            }
+            const bool is_rate = strstr(metric.key, "success_rate") != nullptr;
+            const double allowed = is_rate ? 0.0 : tolerance * base->second;
+            const bool regressed = metric.higherIsWorse ? cur->second > base->second + allowed
+                                                        : cur->second < base->second - allowed - 1e-9;
+            fprintf(stderr, "%-34s baseline %12.4f current %12.4f %s\n", metric.key, base->second,
+                    cur->second, regressed ? "REGRESSION" : "ok");
+            regressions += regressed ? 1 : 0;
+        }
+        return regressions;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    PlannerConfig config;
+    config.search.rsTablePath = options.rsTablePath;
+    config.search.batchRollout = !options.scalarRollout;
+    config.search.useLattice = options.lattice;
+    config.enableGeometric = options.geometric;
+    config.enableShortcut = options.shortcut;
+    config.coarseToFineChecks = options.coarseToFine;
+    PlanningPipeline pipeline(config);
+    if (!options.rsTablePath.empty() && !pipeline.RsTableLoaded())
+    {
+        cerr << "failed to load Reeds-Shepp table " << options.rsTablePath << endl;
+        return 1;
+    }
+    map<string, CategoryStats> categories;
+    unique_ptr<ContainerStats> containers;
+    if (options.containers)
+    {
+        containers.reset(new ContainerStats());
+        pipeline.SetRecorder(&containers->recorder);
+    }
+
+    if (!options.logPath.empty())
+    {
+        ScenarioLogReader reader;
+        const auto t0 = chrono::steady_clock::now();
+        if (!reader.Open(options.logPath))
+        {
+            cerr << "failed to open scenario log " << options.logPath << endl;
+            return 1;
+        }
+        fprintf(stderr, "loaded %zu scenarios in %.3f ms\n", reader.Size(),
+                chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        ScenarioView view;
+        for (size_t i = 0; i < reader.Size(); ++i)
+        {
+            if (!reader.Get(i, &view))
+            {
+                cerr << "corrupted scenario record " << i << endl;
+                return 1;
+            }
+            ObstacleView obstacles;
+            obstacles.polygonOffsets = view.polygonOffsets;
+            obstacles.vertices = view.vertices;
+            obstacles.points = view.points;
+            RunScenario(&pipeline, view.map, obstacles, view.start, view.target, options.repeat,
+                        options.budgetMs, &categories["recorded"], containers.get());
+        }
+    }
+    else
+    {
+        ScenarioGenerator generator(pipeline.Config().vehicle);
+        ScenarioLogWriter writer;
+        if (!options.recordPath.empty() && !writer.Open(options.recordPath))
+        {
+            cerr << "failed to create scenario log " << options.recordPath << endl;
+            return 1;
+        }
+        const ParkingType types[] = {ParkingType::PERPENDICULAR, ParkingType::PARALLEL,
+                                     ParkingType::ANGLED, ParkingType::NARROW_AISLE};
+        vector<uint32_t> offsets;
+        vector<xviz::Vec2f> vertices;
+        for (const ParkingType type : types)
+        {
+            for (int i = 0; i < options.countPerCategory; ++i)
+            {
+                const GeneratedScenario scenario = generator.Generate(type, options.seed * 100003u + i);
+                if (!options.recordPath.empty())
+                {
+                    writer.Append(scenario.start, scenario.target, scenario.map, scenario.polygons,
+                                  scenario.cloud);
+                }
+                offsets.assign(1, 0);
+                vertices.clear();
+                for (const auto &polygon : scenario.polygons.polygons)
+                {
+                    vertices.insert(vertices.end(), polygon.points.begin(), polygon.points.end());
+                    offsets.push_back(static_cast<uint32_t>(vertices.size()));
+                }
+                ObstacleView obstacles;
+                obstacles.polygonOffsets = offsets;
+                obstacles.vertices = vertices;
+                obstacles.points = scenario.cloud.points;
+                RunScenario(&pipeline, scenario.map, obstacles, scenario.start, scenario.target,
+                            options.repeat, options.budgetMs, &categories[scenario.category], containers.get());
+            }
+        }
+        if (!options.recordPath.empty() && !writer.Close())
+        {
+            cerr << "failed to write scenario log " << options.recordPath << endl;
+            return 1;
+        }
+    }
+
+    CategoryStats overall;
+    for (const auto &item : categories)
+    {
+        overall.Merge(item.second);
+    }
+
+    JsonWriter json;
+    json.BeginObject();
+    json.String("benchmark", "scenario_bench");
+    json.String("source", options.logPath.empty() ? "generated" : options.logPath);
+    json.Number("seed", options.seed);
+    json.Number("repeat", options.repeat);
+    WriteStats(&json, "overall", overall);
+    json.BeginObject("categories");
+    for (const auto &item : categories)
+    {
+        WriteStats(&json, item.first, item.second);
+    }
+    json.EndObject();
+#ifdef AUTO_PARKING_ENABLE_PROFILING
+    // 全部运行的累计值
+    const ProfileFrame profile = Profiler::Instance().Collect();
+    json.BeginObject("profile");
+    for (int i = 0; i < kProfileChannelCount; ++i)
+    {
+        json.Number(ChannelName(static_cast<ProfileChannel>(i)), profile.values[i]);
+    }
+    json.EndObject();
+#endif
+    if (containers)
+    {
+        containers->Write(&json);
+    }
+    const TaskSchedulerStats scheduler = TaskScheduler::Instance().Stats();
+    json.BeginObject("scheduler");
+    json.Number("workers", scheduler.workers);
+    json.Number("tasks", static_cast<double>(scheduler.tasks));
+    json.Number("steals", static_cast<double>(scheduler.steals));
+    json.Number("utilization", scheduler.Utilization());
+    json.EndObject();
+    json.Number("peak_rss_mb", PeakResidentBytes() / (1024.0 * 1024.0));
+    json.EndObject();
+    const string text = json.Str();
+
+    if (options.outputPath.empty())
+    {
+        cout << text;
+    }
+    else
+    {
+        ofstream out(options.outputPath);
+        out << text;
+        if (!out.good())
+        {
+            cerr << "failed to write " << options.outputPath << endl;
+            return 1;
+        }
+    }
+
+    if (!options.baselinePath.empty())
+    {
+        map<string, double> current, baseline;
+        FlatJsonReader reader;
+        if (!reader.Parse(text, &current) || !FlatJsonReader().ParseFile(options.baselinePath, &baseline))
+        {
+            cerr << "failed to parse baseline " << options.baselinePath << endl;
+            return 1;
+        }
+        if (CompareWithBaseline(current, baseline, options.tolerance) > 0)
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 14:36:12
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 14:36:12
+ */
+#include "scenario_generator.h"
+#include "map/grid_map_utils.h"
+#include "math/math_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace auto_parking_planning
+{
+    namespace
+    {
+        constexpr float kMapWidth = 36.0f;
+        constexpr float kMapHeight = 24.0f;
+        constexpr float kResolution = 0.1f;
+        constexpr unsigned char kWallValue = 100;
+        constexpr float kDeg60 = static_cast<float>(M_PI) / 3.0f;
+
+        class Builder
+        {
+        public:
+            Builder(GeneratedScenario *scenario, const VehicleParam &vehicle, const uint32_t seed)
+                : m_scenario(scenario), m_vehicle(vehicle), m_rng(seed)
+            {
+                const int width = static_cast<int>(kMapWidth / kResolution);
+                const int height = static_cast<int>(kMapHeight / kResolution);
+                m_scenario->grid.assign(static_cast<size_t>(width) * height, 0);
+                xviz::GridMap &map = m_scenario->map;
+                map.m_res = kResolution;
+                map.m_origin = xviz::Vec2f(0.0f, 0.0f);
+                map.m_originYaw = 0.0f;
+                map.m_size = xviz::Vec2f(static_cast<float>(width), static_cast<float>(height));
+                map.m_dataPtr = 0;
+                map.m_usePtr = true;
+                map.m_data = m_scenario->grid.data();
+            }
+
+            float Uniform(const float lo, const float hi)
+            {
+                return std::uniform_real_distribution<float>(lo, hi)(m_rng);
+            }
+
+            bool Chance(const float p) { return Uniform(0.0f, 1.0f) < p; }
+
+            int Index(const int lo, const int hi)
+            {
+                return std::uniform_int_distribution<int>(lo, hi)(m_rng);
+            }
+
+            /// 世界系轴对齐矩形写入栅格(墙体, 路沿)
+            void FillRect(const float x0, const float y0, const float x1, const float y1)
+            {
+                const xviz::GridMap &map = m_scenario->map;
+                const int c0 = std::max(0, static_cast<int>(x0 / kResolution));
+                const int c1 = std::min(GridWidth(map), static_cast<int>(std::ceil(x1 / kResolution)));
+                const int r0 = std::max(0, static_cast<int>(y0 / kResolution));
+                const int r1 = std::min(GridHeight(map), static_cast<int>(std::ceil(y1 / kResolution)));
+                for (int r = r0; r < r1; ++r)
+                {
+                    std::fill(m_scenario->grid.begin() + static_cast<size_t>(r) * GridWidth(map) + c0,
+                              m_scenario->grid.begin() + static_cast<size_t>(r) * GridWidth(map) + c1,
+                              kWallValue);
+                }
+            }
+
+            /// 以几何中心给出的停放车辆
+            void AddCar(const float cx, const float cy, const float yaw)
+            {
+                const float hl = 0.5f * m_vehicle.length;
+                const float hw = 0.5f * m_vehicle.width;
+                const float c = cosf(yaw), s = sinf(yaw);
+                const float local[4][2] = {{-hl, -hw}, {hl, -hw}, {hl, hw}, {-hl, hw}};
+                xviz::Polygon2f polygon;
+                for (const auto &p : local)
+                {
+                    polygon.points.emplace_back(cx + c * p[0] - s * p[1], cy + s * p[0] + c * p[1]);
+                }
+                m_scenario->polygons.polygons.push_back(polygon);
+            }
+
+            /// 沿墙体的激光点
+            void AddWallPoints(const float y, const int count)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    m_scenario->cloud.points.emplace_back(Uniform(0.0f, kMapWidth), y, Uniform(0.1f, 1.5f));
+                }
+            }
+
+            void SetStart(const float x, const float y, const float yaw)
+            {
+                m_scenario->start = xviz::Pose(x, y, yaw);
+            }
+
+            void SetTarget(const float x, const float y, const float yaw)
+            {
+                m_scenario->target = xviz::Pose(x, y, yaw);
+            }
+
+        private:
+            GeneratedScenario *m_scenario;
+            const VehicleParam &m_vehicle;
+            std::mt19937 m_rng;
+        };
+
+        /// 垂直车位, 倒车入库; narrow 时通道更窄且对侧也有一排车位
+        void BuildPerpendicular(Builder *b, const VehicleParam &vehicle, const bool narrow)
+        {
+            const float slot_width = 2.6f;
+            const float slot_depth = 5.3f;
+            const float slot_y0 = 1.0f;
+            const float aisle_y0 = slot_y0 + slot_depth;
+            const float aisle_width = narrow ? 5.5f : 6.5f;
+            const float aisle_y1 = aisle_y0 + aisle_width;
+            const int slot_count = 12;
+            const float first_x = 2.0f;
+
+            b->FillRect(0.0f, 0.0f, kMapWidth, slot_y0 - 0.2f);
+            const int target = b->Index(4, 7);
+            for (int i = 0; i < slot_count; ++i)
+            {
+                const float cx = first_x + (i + 0.5f) * slot_width;
+                const bool neighbour = std::abs(i - target) == 1;
+                if (i != target && (neighbour || b->Chance(0.7f)))
+                {
+                    b->AddCar(cx + b->Uniform(-0.1f, 0.1f), slot_y0 + 0.5f * slot_depth + b->Uniform(-0.2f, 0.2f),
+                              0.5f * static_cast<float>(M_PI) + b->Uniform(-0.04f, 0.04f));
+                }
+            }
+            if (narrow)
+            {
+                for (int i = 0; i < slot_count; ++i)
+                {
+                    if (b->Chance(0.8f))
+                    {
+                        const float cx = first_x + (i + 0.5f) * slot_width;
+                        b->AddCar(cx + b->Uniform(-0.1f, 0.1f), aisle_y1 + 0.5f * slot_depth,
+                                  -0.5f * static_cast<float>(M_PI) + b->Uniform(-0.04f, 0.04f));
+                    }
+                }
+                b->FillRect(0.0f, aisle_y1 + slot_depth + 0.2f, kMapWidth, kMapHeight);
+            }
+            else
+            {
+                b->FillRect(0.0f, aisle_y1, kMapWidth, kMapHeight);
+            }
+            b->AddWallPoints(slot_y0 - 0.15f, 200);
+
+            const float target_x = first_x + (target + 0.5f) * slot_width;
+            b->SetTarget(target_x, slot_y0 + 0.3f + vehicle.rearOverhang, 0.5f * static_cast<float>(M_PI));
+            b->SetStart(target_x - b->Uniform(3.0f, 8.0f), aisle_y0 + 0.5f * aisle_width + b->Uniform(-0.3f, 0.3f),
+                        b->Uniform(-0.1f, 0.1f));
+        }
+
+        /// 平行车位, 路沿在下方, 倒车入位
+        void BuildParallel(Builder *b, const VehicleParam &vehicle)
+        {
+            const float slot_length = 6.8f;
+            const float slot_depth = 2.5f;
+            const float curb_y = 1.0f;
+            const float lane_y1 = curb_y + slot_depth + 6.0f;
+            const float first_x = 1.0f;
+            const int slot_count = 5;
+
+            b->FillRect(0.0f, 0.0f, kMapWidth, curb_y);
+            b->FillRect(0.0f, lane_y1, kMapWidth, kMapHeight);
+            const int target = b->Index(1, 2);
+            for (int i = 0; i < slot_count; ++i)
+            {
+                const bool neighbour = std::abs(i - target) == 1;
+                if (i != target && (neighbour || b->Chance(0.7f)))
+                {
+                    const float cx = first_x + (i + 0.5f) * slot_length;
+                    b->AddCar(cx + b->Uniform(-0.2f, 0.2f), curb_y + 0.5f * slot_depth + b->Uniform(-0.1f, 0.1f),
+                              b->Uniform(-0.03f, 0.03f));
+                }
+            }
+            b->AddWallPoints(curb_y + 0.05f, 200);
+
+            const float slot_x0 = first_x + target * slot_length;
+            b->SetTarget(slot_x0 + 0.5f * (slot_length - vehicle.length) + vehicle.rearOverhang,
+                         curb_y + 0.5f * slot_depth, 0.0f);
+            b->SetStart(slot_x0 + slot_length + b->Uniform(1.0f, 4.0f), curb_y + slot_depth + 2.0f + b->Uniform(-0.3f, 0.3f),
+                        b->Uniform(-0.1f, 0.1f));
+        }
+
+        /// 60 度斜列车位, 车头朝内前进入位
+        void BuildAngled(Builder *b, const VehicleParam &vehicle)
+        {
+            const float slot_pitch = 3.0f;
+            const float slot_depth = 5.3f;
+            const float aisle_y0 = 7.0f;
+            const float aisle_y1 = aisle_y0 + 5.5f;
+            const float first_x = 2.0f;
+            const int slot_count = 9;
+            const float yaw = -kDeg60;
+            const float dx = cosf(yaw), dy = sinf(yaw);
+
+            b->FillRect(0.0f, 0.0f, kMapWidth, aisle_y0 - slot_depth * sinf(kDeg60) - 0.6f);
+            b->FillRect(0.0f, aisle_y1, kMapWidth, kMapHeight);
+            const int target = b->Index(4, 6);
+            for (int i = 0; i < slot_count; ++i)
+            {
+                const bool neighbour = std::abs(i - target) == 1;
+                if (i != target && (neighbour || b->Chance(0.7f)))
+                {
+                    const float mx = first_x + (i + 0.5f) * slot_pitch;
+                    const float depth = 0.3f + 0.5f * vehicle.length + b->Uniform(-0.1f, 0.2f);
+                    b->AddCar(mx + dx * depth, aisle_y0 + dy * depth, yaw + b->Uniform(-0.03f, 0.03f));
+                }
+            }
+
+            const float mx = first_x + (target + 0.5f) * slot_pitch;
+            // 车尾距车位口 0.3m, 后轴再向内 rearOverhang
+            const float axle = 0.3f + vehicle.rearOverhang;
+            b->SetTarget(mx + dx * axle, aisle_y0 + dy * axle, yaw);
+            b->SetStart(mx - b->Uniform(5.0f, 9.0f), 0.5f * (aisle_y0 + aisle_y1) + b->Uniform(-0.3f, 0.3f),
+                        b->Uniform(-0.1f, 0.1f));
+        }
+    }
+
+    const char *ToString(const ParkingType type)
+    {
+        switch (type)
+        {
+        case ParkingType::PERPENDICULAR:
+            return "perpendicular";
+        case ParkingType::PARALLEL:
+            return "parallel";
+        case ParkingType::ANGLED:
+            return "angled";
+        case ParkingType::NARROW_AISLE:
+            return "narrow_aisle";
+        }
+        return "unknown";
+    }
+
+    ScenarioGenerator::ScenarioGenerator(const VehicleParam &vehicle) : m_vehicle(vehicle) {}
+
+    GeneratedScenario ScenarioGenerator::Generate(const ParkingType type, const uint32_t seed) const
+    {
+        GeneratedScenario scenario;
+        scenario.category = ToString(type);
+        Builder builder(&scenario, m_vehicle, seed * 4u + static_cast<uint32_t>(type));
+        switch (type)
+        {
+        case ParkingType::PERPENDICULAR:
+            BuildPerpendicular(&builder, m_vehicle, false);
+            break;
+        case ParkingType::PARALLEL:
+            BuildParallel(&builder, m_vehicle);
+            break;
+        case ParkingType::ANGLED:
+            BuildAngled(&builder, m_vehicle);
+            break;
+        case ParkingType::NARROW_AISLE:
+            BuildPerpendicular(&builder, m_vehicle, true);
+            break;
+        }
+        return scenario;
+    }
+
+} // namespace auto_parking_planning
@@ -0,0 +1,55 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-13 14:08:45
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-13 14:08:45
+ */
+
+#ifndef __SCENARIO_GENERATOR_H__
+#define __SCENARIO_GENERATOR_H__
+
+#include "data_types.h"
+#include "planner/vehicle_param.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace auto_parking_planning
+{
+    enum class ParkingType
+    {
+        PERPENDICULAR = 0,
+        PARALLEL = 1,
+        ANGLED = 2,
+        NARROW_AISLE = 3,
+    };
+
+    const char *ToString(const ParkingType type);
+
+    /// @brief 生成的泊车场景, 栅格为墙体/路沿, 停放车辆以多边形给出, 点云为散布的障碍点
+    struct GeneratedScenario
+    {
+        std::string category;
+        xviz::Pose start;
+        xviz::Pose target;
+        std::vector<unsigned char> grid;
+        xviz::GridMap map;
+        xviz::Polygons2f polygons;
+        xviz::PointCloud3f cloud;
+    };
+
+    class ScenarioGenerator
+    {
+    public:
+        explicit ScenarioGenerator(const VehicleParam &vehicle = VehicleParam());
+
+        /// @brief 同一 (type, seed) 总生成相同场景
+        GeneratedScenario Generate(const ParkingType type, const uint32_t seed) const;
+
+    private:
+        VehicleParam m_vehicle;
+    };
+
+} // namespace auto_parking_planning
+
+#endif /* __SCENARIO_GENERATOR_H__ */
@@ -0,0 +1,70 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-18 21:20:16
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-18 21:20:16
+ */
+#include "planner/rs_table.h"
+#include "planner/vehicle_param.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace auto_parking_planning;
+
+namespace
+{
+    void PrintUsage()
+    {
+        cerr << "usage: rs_table_gen --output FILE [options]\n"
+             << "  --radius R        minimum turning radius in meters (default: vehicle parameters)\n"
+             << "  --resolution D    position resolution in meters (default 0.25)\n"
+             << "  --range L         tabulated |dx|, |dy| range in meters (default 15)\n"
+             << "  --heading-bins N  heading bins (default 72)\n";
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    ReedsSheppTableSpec spec;
+    spec.turningRadius = VehicleParam().MinTurningRadius();
+    string output;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--output" && has_value)
+            output = argv[++i];
+        else if (arg == "--radius" && has_value)
+            spec.turningRadius = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--resolution" && has_value)
+            spec.resolution = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--range" && has_value)
+            spec.range = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--heading-bins" && has_value)
+            spec.headingBins = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (output.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    const auto t0 = chrono::steady_clock::now();
+    if (!ReedsSheppTable::Generate(spec, output))
+    {
+        cerr << "failed to generate " << output << endl;
+        return 1;
+    }
+    fprintf(stderr, "wrote %s (radius %.3f m) in %.1f s\n", output.c_str(), spec.turningRadius,
+            chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-27 21:05:38
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-27 21:05:38
+ */
+#include "map/grid_map_utils.h"
+#include "map/tiled_map.h"
+#include "record/scenario_log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace auto_parking_planning;
+
+namespace
+{
+    void PrintUsage()
+    {
+        cerr << "usage: tiled_map_gen --output FILE (--log FILE [--index I] | --garage W H) [options]\n"
+             << "  --log FILE       convert the map of a recorded scenario\n"
+             << "  --index I        scenario index in the log (default 0)\n"
+             << "  --garage W H     synthesize a W x H meter garage floor with stall rows and pillars\n"
+             << "  --resolution D   garage cell size in meters (default 0.1)\n"
+             << "  --tile N         tile size in cells (default 256)\n"
+             << "  --seed S         garage generator seed (default 1)\n";
+    }
+
+    /// @brief 停车楼层: 外墙, 每 16 米一组背靠背的车位排, 排间为车道, 车位随机停车, 柱网 8 米
+    xviz::GridMap Garage(const float width, const float height, const float res, const uint32_t seed,
+                         vector<unsigned char> *grid)
+    {
+        const int cols = static_cast<int>(width / res);
+        const int rows = static_cast<int>(height / res);
+        grid->assign(static_cast<size_t>(cols) * rows, 0);
+        const auto fill = [&](const float x0, const float y0, const float x1, const float y1) {
+            const int i0 = max(0, static_cast<int>(x0 / res));
+            const int j0 = max(0, static_cast<int>(y0 / res));
+            const int i1 = min(cols, static_cast<int>(x1 / res));
+            const int j1 = min(rows, static_cast<int>(y1 / res));
+            for (int j = j0; j < j1; ++j)
+            {
+                for (int i = i0; i < i1; ++i)
+                {
+                    (*grid)[static_cast<size_t>(j) * cols + i] = 100;
+                }
+            }
+        };
+
+        mt19937 rng(seed);
+        uniform_real_distribution<float> occupied(0.0f, 1.0f);
+        const float wall = 0.3f;
+        fill(0.0f, 0.0f, width, wall);
+        fill(0.0f, height - wall, width, height);
+        fill(0.0f, 0.0f, wall, height);
+        fill(width - wall, 0.0f, width, height);
+        const float stall_width = 2.6f;
+        const float stall_depth = 5.0f;
+        for (float row = 6.5f; row + 2.0f * stall_depth < height - 6.5f; row += 2.0f * stall_depth + 6.5f)
+        {
+            for (float x = 2.0f; x + stall_width < width - 2.0f; x += stall_width)
+            {
+                for (int side = 0; side < 2; ++side)
+                {
+                    if (occupied(rng) < 0.7f)
+                    {
+                        const float y = row + side * stall_depth;
+                        fill(x + 0.3f, y + 0.1f, x + stall_width - 0.3f, y + stall_depth - 0.1f);
+                    }
+                }
+            }
+            for (float x = 8.0f; x < width - 2.0f; x += 8.0f)
+            {
+                fill(x - 0.3f, row + stall_depth - 0.3f, x + 0.3f, row + stall_depth + 0.3f);
+            }
+        }
+
+        xviz::GridMap map;
+        map.m_res = res;
+        map.m_size = xviz::Vec2f(static_cast<float>(cols), static_cast<float>(rows));
+        map.m_origin = xviz::Vec2f(0.0f, 0.0f);
+        map.m_originYaw = 0.0f;
+        map.m_data = grid->data();
+        return map;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    string output;
+    string log_path;
+    size_t index = 0;
+    float garage_width = 0.0f;
+    float garage_height = 0.0f;
+    float resolution = 0.1f;
+    int tile_size = 256;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--output" && has_value)
+            output = argv[++i];
+        else if (arg == "--log" && has_value)
+            log_path = argv[++i];
+        else if (arg == "--index" && has_value)
+            index = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--garage" && i + 2 < argc)
+        {
+            garage_width = static_cast<float>(atof(argv[++i]));
+            garage_height = static_cast<float>(atof(argv[++i]));
+        }
+        else if (arg == "--resolution" && has_value)
+            resolution = static_cast<float>(atof(argv[++i]));
+        else if (arg == "--tile" && has_value)
+            tile_size = atoi(argv[++i]);
+        else if (arg == "--seed" && has_value)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (output.empty() || log_path.empty() == (garage_width <= 0.0f || garage_height <= 0.0f) ||
+        resolution <= 0.0f)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ScenarioLogReader reader;
+    ScenarioView view;
+    vector<unsigned char> grid;
+    xviz::GridMap map;
+    if (!log_path.empty())
+    {
+        if (!reader.Open(log_path) || !reader.Get(index, &view))
+        {
+            cerr << "failed to load scenario " << index << " from " << log_path << endl;
+            return 1;
+        }
+        map = view.map;
+    }
+    else
+    {
+        map = Garage(garage_width, garage_height, resolution, seed, &grid);
+    }
+
+    const auto t0 = chrono::steady_clock::now();
+    if (!TiledMap::Write(map, tile_size, output))
+    {
+        cerr << "failed to write " << output << endl;
+        return 1;
+    }
+    fprintf(stderr, "wrote %s (%d x %d cells, tile %d) in %.1f s\n", output.c_str(), GridWidth(map),
+            GridHeight(map), tile_size, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-20 14:52:03
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-20 14:52:03
+ */
+
+#ifndef __HEADLESS_BRIDGE_H__
+#define __HEADLESS_BRIDGE_H__
+
+#include "data_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 进程内 XvizMsgBridge 后端的附加接口. XvizMsgBridge 本身的接口与 xvizMsgBridge.h 完全一致:
+// 发布的消息不序列化也不走网络, 只把摘要写入进程内共享的无锁环形缓冲;
+// 位姿回调由 SendInitPose / SendTargetPose 回环触发, 与真实后端一样在各 bridge 的接收线程上执行
+namespace xviz
+{
+    namespace headless
+    {
+        enum class MessageType : uint8_t
+        {
+            PATH = 0,
+            POSE,
+            POINT_CLOUD,
+            POLYGON,
+            POLYGONS,
+            CIRCLE,
+            BEZIER,
+            MARKER_ARRAY,
+            FLOAT_DATA,
+            STRING_DATA,
+            GRID_MAP,
+            TRANSFORM,
+        };
+
+        /// @brief 一条已发布消息的摘要
+        struct Message
+        {
+            uint64_t seq;
+            MessageType type;
+            /// 点、多边形、标记等元素个数
+            uint32_t count;
+            /// FloatDataPub 的数值
+            float value;
+            /// 话题名, 超长截断
+            char topic[48];
+        };
+
+        struct SinkStats
+        {
+            uint64_t published;
+            uint64_t dropped;
+        };
+
+        /// @brief 取出至多 max_count 条消息, 返回取出条数
+        size_t Drain(std::vector<Message> *out, const size_t max_count = SIZE_MAX);
+
+        /// @brief 发布总数与缓冲满时丢弃的条数
+        SinkStats Stats();
+
+        /// @brief 回环发送初始/目标位姿给所有运行中的 bridge
+        void SendInitPose(const Pose &pose);
+
+        void SendTargetPose(const Pose &pose);
+    }
+}
+
+#endif /* __HEADLESS_BRIDGE_H__ */
@@ -0,0 +1,114 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-20 14:18:36
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-20 14:18:36
+ */
+
+#ifndef __MPMC_RING_H__
+#define __MPMC_RING_H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace xviz
+{
+    namespace headless
+    {
+        /// @brief 有界多生产者多消费者无锁环形队列(每个槽位带序号).
+        /// 满时 TryPush 立即失败, 由调用方决定丢弃, 生产者永不阻塞
+        template <typename T>
+        class MpmcRing
+        {
+        public:
+            /// capacity 向上取整为 2 的幂
+            explicit MpmcRing(const size_t capacity)
+            {
+                size_t n = 2;
+                while (n < capacity)
+                {
+                    n <<= 1;
+                }
+                m_mask = n - 1;
+                m_cells.reset(new Cell[n]);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    m_cells[i].seq.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            bool TryPush(const T &value)
+            {
+                size_t pos = m_enqueue.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    Cell &cell = m_cells[pos & m_mask];
+                    const size_t seq = cell.seq.load(std::memory_order_acquire);
+                    const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                    if (diff == 0)
+                    {
+                        if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            cell.data = value;
+                            cell.seq.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        pos = m_enqueue.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            bool TryPop(T *value)
+            {
+                size_t pos = m_dequeue.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    Cell &cell = m_cells[pos & m_mask];
+                    const size_t seq = cell.seq.load(std::memory_order_acquire);
+                    const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                    if (diff == 0)
+                    {
+                        if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            *value = cell.data;
+                            cell.seq.store(pos + m_mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        pos = m_dequeue.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            size_t Capacity() const { return m_mask + 1; }
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_t> seq;
+                T data;
+            };
+
+            std::unique_ptr<Cell[]> m_cells;
+            size_t m_mask = 0;
+            alignas(64) std::atomic<size_t> m_enqueue{0};
+            alignas(64) std::atomic<size_t> m_dequeue{0};
+        };
+    }
+}
+
+#endif /* __MPMC_RING_H__ */
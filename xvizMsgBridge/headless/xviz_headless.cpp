@@ -0,0 +1,335 @@
+/**
+ * @Author: Xia Yunkai
+ * @Date:   2024-01-20 15:06:44
+ * @Last Modified by:   Xia Yunkai
+ * @Last Modified time: 2024-01-20 15:06:44
+ */
+#include "xvizMsgBridge.h"
+#include "headless_bridge.h"
+#include "mpmc_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <vector>
+
+// 头文件只前置声明了 zmq 的两个类型, 无界面后端在这里给出自己的定义:
+// context_t 保存每个 bridge 的回环收件队列, socket_t 只记录连接地址
+namespace zmq
+{
+    class context_t
+    {
+    public:
+        enum class PoseKind : uint8_t
+        {
+            INIT,
+            TARGET,
+        };
+
+        struct PoseEvent
+        {
+            PoseKind kind;
+            xviz::Pose pose;
+        };
+
+        context_t() : inbox(kInboxCapacity) {}
+
+        void Post(const PoseKind kind, const xviz::Pose &pose)
+        {
+            if (inbox.TryPush(PoseEvent{kind, pose}))
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                wake.notify_one();
+            }
+        }
+
+        static constexpr size_t kInboxCapacity = 64;
+
+        xviz::headless::MpmcRing<PoseEvent> inbox;
+        std::atomic<bool> running{false};
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+    };
+
+    class socket_t
+    {
+    public:
+        explicit socket_t(const std::string &endpoint) : endpoint(endpoint) {}
+
+        std::string endpoint;
+    };
+}
+
+namespace xviz
+{
+    namespace headless
+    {
+        namespace
+        {
+            constexpr size_t kSinkCapacity = 1 << 14;
+            /// 投递与关闭都会唤醒接收线程, 超时只是兜底
+            constexpr auto kReceivePollPeriod = std::chrono::milliseconds(20);
+
+            struct Sink
+            {
+                Sink() : ring(kSinkCapacity) {}
+
+                MpmcRing<Message> ring;
+                std::atomic<uint64_t> sequence{0};
+                std::atomic<uint64_t> dropped{0};
+            };
+
+            Sink &GetSink()
+            {
+                static Sink sink;
+                return sink;
+            }
+
+            /// 运行中的 bridge, 回环发送时逐个投递
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<zmq::context_t *> contexts;
+            };
+
+            Registry &GetRegistry()
+            {
+                static Registry registry;
+                return registry;
+            }
+
+            void Register(zmq::context_t *ctx)
+            {
+                Registry &registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.contexts.push_back(ctx);
+            }
+
+            void Unregister(zmq::context_t *ctx)
+            {
+                Registry &registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.contexts.erase(std::remove(registry.contexts.begin(), registry.contexts.end(), ctx),
+                                        registry.contexts.end());
+            }
+
+            void Broadcast(const zmq::context_t::PoseKind kind, const Pose &pose)
+            {
+                Registry &registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                for (zmq::context_t *ctx : registry.contexts)
+                {
+                    ctx->Post(kind, pose);
+                }
+            }
+
+            void Record(const MessageType type, const std::string &topic, const size_t count, const float value = 0.0f)
+            {
+                Sink &sink = GetSink();
+                Message msg;
+                msg.seq = sink.sequence.fetch_add(1, std::memory_order_relaxed);
+                msg.type = type;
+                msg.count = static_cast<uint32_t>(count);
+                msg.value = value;
+                const size_t len = std::min(topic.size(), sizeof(msg.topic) - 1);
+                std::memcpy(msg.topic, topic.data(), len);
+                msg.topic[len] = '\0';
+                if (!sink.ring.TryPush(msg))
+                {
+                    sink.dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_t Drain(std::vector<Message> *out, const size_t max_count)
+        {
+            Sink &sink = GetSink();
+            size_t n = 0;
+            Message msg;
+            while (n < max_count && sink.ring.TryPop(&msg))
+            {
+                out->push_back(msg);
+                ++n;
+            }
+            return n;
+        }
+
+        SinkStats Stats()
+        {
+            const Sink &sink = GetSink();
+            SinkStats stats;
+            stats.published = sink.sequence.load(std::memory_order_relaxed);
+            stats.dropped = sink.dropped.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void SendInitPose(const Pose &pose) { Broadcast(zmq::context_t::PoseKind::INIT, pose); }
+
+        void SendTargetPose(const Pose &pose) { Broadcast(zmq::context_t::PoseKind::TARGET, pose); }
+    }
+
+    using headless::MessageType;
+    using headless::Record;
+
+    XvizMsgBridge::XvizMsgBridge() : m_running(false) {}
+
+    XvizMsgBridge::~XvizMsgBridge() { Shutdown(); }
+
+    bool XvizMsgBridge::Init(const std::string &pub_connect, const std::string &sub_connect)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_pubConnect = pub_connect;
+        m_subConnect = sub_connect;
+        if (!m_ctx)
+        {
+            m_ctx.reset(new zmq::context_t());
+        }
+        m_pub.reset(new zmq::socket_t(pub_connect));
+        m_sub.reset(new zmq::socket_t(sub_connect));
+        return true;
+    }
+
+    void XvizMsgBridge::Run()
+    {
+        if (!m_ctx || m_running)
+        {
+            return;
+        }
+        m_running = true;
+        m_ctx->running.store(true);
+        headless::Register(m_ctx.get());
+        m_receiveThread = std::thread(&XvizMsgBridge::ReceiveLoop, this);
+    }
+
+    void XvizMsgBridge::ReceiveLoop()
+    {
+        zmq::context_t &ctx = *m_ctx;
+        zmq::context_t::PoseEvent event;
+        while (ctx.running.load())
+        {
+            if (!ctx.inbox.TryPop(&event))
+            {
+                // 持锁再取一次: Post 在锁内通知, 两次检查之间的投递不会丢失唤醒
+                std::unique_lock<std::mutex> lock(ctx.wakeMutex);
+                if (!ctx.wake.wait_for(lock, headless::kReceivePollPeriod,
+                                       [&ctx, &event]() { return !ctx.running.load() || ctx.inbox.TryPop(&event); }) ||
+                    !ctx.running.load())
+                {
+                    continue;
+                }
+            }
+            PoseCallbackFunc callback;
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                if (event.kind == zmq::context_t::PoseKind::INIT && m_bSetInitPoseCB)
+                {
+                    callback = m_initPoseCB;
+                }
+                else if (event.kind == zmq::context_t::PoseKind::TARGET && m_bSetTarPoseCB)
+                {
+                    callback = m_tarPoseCB;
+                }
+            }
+            if (callback)
+            {
+                callback(event.pose);
+            }
+        }
+    }
+
+    void XvizMsgBridge::SetInitPoseFunc(const PoseCallbackFunc &func)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_initPoseCB = func;
+        m_bSetInitPoseCB = true;
+    }
+
+    void XvizMsgBridge::SetTargetPoseFunc(const PoseCallbackFunc &func)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_tarPoseCB = func;
+        m_bSetTarPoseCB = true;
+    }
+
+    void XvizMsgBridge::PathPub(const std::string &topic, const Path2f &path)
+    {
+        Record(MessageType::PATH, topic, path.points.size());
+    }
+
+    void XvizMsgBridge::PosePub(const std::string &topic, const Pose &/*pose*/)
+    {
+        Record(MessageType::POSE, topic, 1);
+    }
+
+    void XvizMsgBridge::PointCloudPub(const std::string &topic, const PointCloud3f &pointcloud)
+    {
+        Record(MessageType::POINT_CLOUD, topic, pointcloud.points.size());
+    }
+
+    void XvizMsgBridge::PolygonPub(const std::string &topic, const Polygon2f &polygon)
+    {
+        Record(MessageType::POLYGON, topic, polygon.points.size());
+    }
+
+    void XvizMsgBridge::PolygonsPub(const std::string &topic, const Polygons2f &polygons)
+    {
+        Record(MessageType::POLYGONS, topic, polygons.polygons.size());
+    }
+
+    void XvizMsgBridge::CirclePub(const std::string &topic, const Circle &circle)
+    {
+        Record(MessageType::CIRCLE, topic, 1, circle.radius);
+    }
+
+    void XvizMsgBridge::BezierPub(const std::string &topic, const Bezier &/*bezier*/)
+    {
+        Record(MessageType::BEZIER, topic, 4);
+    }
+
+    void XvizMsgBridge::MarkerArrayPub(const std::string &topic, const MarkerArray &markerArray)
+    {
+        Record(MessageType::MARKER_ARRAY, topic, markerArray.markers.size());
+    }
+
+    void XvizMsgBridge::FloatDataPub(const std::string &name, const float data)
+    {
+        Record(MessageType::FLOAT_DATA, name, 1, data);
+    }
+
+    void XvizMsgBridge::StringDataPub(const std::string &name, const std::string &data)
+    {
+        Record(MessageType::STRING_DATA, name, data.size());
+    }
+
+    void XvizMsgBridge::GridMapPub(const std::string &name, const GridMap &map)
+    {
+        const size_t cells = map.m_res > 0.0f
+                                 ? static_cast<size_t>(map.m_size.x / map.m_res) * static_cast<size_t>(map.m_size.y / map.m_res)
+                                 : 0;
+        Record(MessageType::GRID_MAP, name, cells);
+    }
+
+    void XvizMsgBridge::TransformPub(const std::string &name, const TransformNode &/*transform*/)
+    {
+        Record(MessageType::TRANSFORM, name, 1);
+    }
+
+    void XvizMsgBridge::Shutdown()
+    {
+        if (m_ctx)
+        {
+            headless::Unregister(m_ctx.get());
+            m_ctx->running.store(false);
+            {
+                std::lock_guard<std::mutex> lock(m_ctx->wakeMutex);
+                m_ctx->wake.notify_all();
+            }
+        }
+        if (m_receiveThread.joinable())
+        {
+            m_receiveThread.join();
+        }
+        m_running = false;
+    }
+}